@@ -0,0 +1,45 @@
+#ifndef CS340_ENUM_NAMES_HXX_
+#define CS340_ENUM_NAMES_HXX_
+
+//------------------------------------------------------------------------------
+//
+// This header contains the helper used to read the enumerations that
+// are chosen by name on the command line. Each enumeration keeps an
+// array of its names, where the position of each name matches the
+// enumerator's value.
+//
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <istream>
+#include <iterator>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+  // Read a name and look it up in names. On failure the stream's
+  // failbit is set, which Boost.ProgramOptions reports as an invalid
+  // option value.
+  template <typename Enum, std::size_t N>
+  std::istream& read_enum_name(std::istream& is, Enum& value,
+    char const* const (&names)[N])
+  {
+    std::string name;
+    if (!(is >> name))
+      return is;
+
+    auto const found = std::find(std::begin(names), std::end(names), name);
+    if (found == std::end(names))
+      is.setstate(std::ios_base::failbit);
+    else
+      value = static_cast<Enum>(found - std::begin(names));
+    return is;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------------
+//
+// This file contains the definitions for the ETC matrix generator and
+// the matrix file format.
+//
+//------------------------------------------------------------------------------
+
+#include "etc.hxx"
+#include "types.hxx"
+#include "enum_names.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+    namespace
+    {
+        // Number of rows generated from one random_generator. This must
+        // never depend on the number of threads, or else the output would.
+        size_t const rows_per_chunk{4096};
+
+        // Upper ends of the ranges used by the range-based method, for low
+        // and high heterogeneity respectively.
+        double const task_range[] = { 100, 3000 };
+        double const machine_range[] = { 10, 1000 };
+
+        char const* const kind_names[] = { "uniform", "etc" };
+        char const* const consistency_names[] = { "consistent", "semi-consistent", "inconsistent" };
+        char const* const heterogeneity_names[] = { "low", "high" };
+
+        // Fill rows [first, last) of the matrix from the given chunk's own
+        // random_generator.
+        void fill_chunk(runtime_matrix& matrix, etc_parameters const& params,
+                uint64_t const seed, size_t const chunk)
+        {
+            seed_seq seq{
+                static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                static_cast<uint32_t>(chunk), static_cast<uint32_t>(chunk >> 32)
+            };
+            random_generator gen{seq};
+
+            uniform_real_distribution<double> task_dist{1,
+                task_range[static_cast<size_t>(params.task_heterogeneity)]};
+            uniform_real_distribution<double> machine_dist{1,
+                machine_range[static_cast<size_t>(params.machine_heterogeneity)]};
+
+            size_t const first{chunk * rows_per_chunk};
+            size_t const last{min(matrix.tasks(), first + rows_per_chunk)};
+            vector<size_t> row(matrix.machines());
+
+            for (size_t i{first}; i < last; ++i)
+            {
+                double const baseline{task_dist(gen)};
+                for (auto& e : row)
+                    e = static_cast<size_t>(llround(baseline * machine_dist(gen)));
+
+                switch (params.consistency)
+                {
+                    case etc_consistency::consistent:
+                        sort(begin(row), end(row));
+                        break;
+
+                    case etc_consistency::semi_consistent:
+                    {
+                        // Sort only the even columns, leaving them where they are.
+                        vector<size_t> even;
+                        for (size_t j{}; j < row.size(); j += 2)
+                            even.push_back(row[j]);
+                        sort(begin(even), end(even));
+                        for (size_t j{}; j < row.size(); j += 2)
+                            row[j] = even[j / 2];
+                        break;
+                    }
+
+                    case etc_consistency::inconsistent:
+                        break;
+                }
+
+                for (size_t j{}; j < row.size(); ++j)
+                    matrix(i, j) = row[j];
+            }
+        }
+    }
+
+    istream& operator >> (istream& is, matrix_kind& k) { return read_enum_name(is, k, kind_names); }
+    istream& operator >> (istream& is, etc_consistency& c) { return read_enum_name(is, c, consistency_names); }
+    istream& operator >> (istream& is, etc_heterogeneity& h) { return read_enum_name(is, h, heterogeneity_names); }
+
+    ostream& operator << (ostream& os, matrix_kind k) { return os << kind_names[static_cast<size_t>(k)]; }
+    ostream& operator << (ostream& os, etc_consistency c) { return os << consistency_names[static_cast<size_t>(c)]; }
+    ostream& operator << (ostream& os, etc_heterogeneity h) { return os << heterogeneity_names[static_cast<size_t>(h)]; }
+
+    runtime_matrix create_etc_matrix(size_t const t, size_t const m,
+            etc_parameters const& params, uint64_t const seed, size_t const threads)
+    {
+        if (threads < 1)
+            throw std::runtime_error("Cannot run on less than 1 thread");
+
+        runtime_matrix matrix{t, m};
+
+        size_t const chunks{(t + rows_per_chunk - 1) / rows_per_chunk};
+        size_t const workers{min(threads, chunks)};
+
+        // Each worker takes every workers-th chunk. Since the chunks never
+        // overlap, the workers never write to the same element.
+        vector<future<void>> done;
+        for (size_t w{1}; w < workers; ++w)
+        {
+            done.push_back(async(launch::async, [&matrix, &params, seed, chunks, workers, w]()
+            {
+                for (size_t c{w}; c < chunks; c += workers)
+                    fill_chunk(matrix, params, seed, c);
+            }));
+        }
+
+        // The calling thread does its share too.
+        for (size_t c{}; c < chunks; c += max(workers, size_t{1}))
+            fill_chunk(matrix, params, seed, c);
+
+        for (auto& d : done)
+            d.get();
+
+        return matrix;
+    }
+
+    void write_matrix(ostream& os, runtime_matrix const& matrix)
+    {
+        os << matrix.tasks() << ' ' << matrix.machines() << '\n' << matrix;
+    }
+
+    runtime_matrix read_matrix(istream& is)
+    {
+        size_t t{}, m{};
+        if (!(is >> t >> m))
+            throw std::runtime_error("Cannot read the matrix dimensions");
+
+        runtime_matrix matrix{t, m};
+        for (size_t i{}; i < t; ++i)
+            for (size_t j{}; j < m; ++j)
+                if (!(is >> matrix(i, j)))
+                    throw std::runtime_error("Cannot read the matrix elements");
+
+        return matrix;
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,77 @@
+#ifndef CS340_ETC_HXX_
+#define CS340_ETC_HXX_
+
+//------------------------------------------------------------------------------
+//
+// This header contains the declarations for generating benchmark
+// instances of the expected time to compute (ETC) kind, as well as for
+// reading and writing runtime matrices to and from files.
+//
+// An ETC matrix is generated with the range-based method: every task
+// gets a baseline time drawn from [1, task range), and every entry in
+// the task's row is that baseline multiplied by a factor drawn from
+// [1, machine range). Low and high heterogeneity pick small or large
+// ranges. The consistency of the matrix then determines how the rows
+// relate to each other:
+//
+// consistent: if a machine is faster than another one for some task,
+// it is faster for every task. (Each row is sorted.)
+//
+// semi-consistent: the even-numbered machines are consistent amongst
+// themselves, the others are not.
+//
+// inconsistent: no structure at all.
+//
+//------------------------------------------------------------------------------
+
+#include "types.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+  // The kinds of matrix that can be generated. The uniform kind is the
+  // one made by create_random_matrix.
+  enum class matrix_kind { uniform, etc };
+  enum class etc_consistency { consistent, semi_consistent, inconsistent };
+  enum class etc_heterogeneity { low, high };
+
+  std::istream& operator >> (std::istream&, matrix_kind&);
+  std::istream& operator >> (std::istream&, etc_consistency&);
+  std::istream& operator >> (std::istream&, etc_heterogeneity&);
+
+  std::ostream& operator << (std::ostream&, matrix_kind);
+  std::ostream& operator << (std::ostream&, etc_consistency);
+  std::ostream& operator << (std::ostream&, etc_heterogeneity);
+
+  // The class of ETC instance to generate.
+  struct etc_parameters
+  {
+    etc_consistency consistency;
+    etc_heterogeneity task_heterogeneity;
+    etc_heterogeneity machine_heterogeneity;
+  };
+
+  // Generate an ETC matrix with t tasks and m machines.
+  //
+  // The rows are generated in fixed-size chunks, each with its own
+  // random_generator seeded from the seed and the chunk number. The
+  // chunks are spread over the given number of threads, and the result
+  // only depends on the seed, never on the number of threads.
+  runtime_matrix create_etc_matrix(std::size_t t, std::size_t m,
+    etc_parameters const&, std::uint64_t seed, std::size_t threads);
+
+  // Write a matrix as its dimensions on the first line followed by one
+  // row per line, and read it back in. Reading throws a
+  // std::runtime_error if the input is malformed.
+  void write_matrix(std::ostream&, runtime_matrix const&);
+  runtime_matrix read_matrix(std::istream&);
+}
+
+//------------------------------------------------------------------------------
+
+#endif
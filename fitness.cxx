@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+//
+// This file contains the definitions for scoring many schedules at once.
+//
+// Each block of score_batch_width schedules is worked through in tiles
+// of tasks. The block's task assignments for a tile are first copied
+// into a buffer, transposed so that the assignments of task t for every
+// schedule in the block sit next to each other. The machine loads are
+// laid out the same way: loads[m * width + lane] is the load of machine
+// m in the lane-th schedule. The lanes of any one task then always hit
+// different loads, so they can all be updated at once without conflict.
+//
+//------------------------------------------------------------------------------
+
+#include "fitness.hxx"
+#include "types.hxx"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CS340_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+    namespace
+    {
+        size_t const width{score_batch_width};
+
+        // Number of tasks copied into the buffer at a time.
+        size_t const tile_size{512};
+
+        // Add the run times of tasks [first_task, first_task + n) to the
+        // loads of every schedule in the block. genes holds the block's
+        // transposed task assignments for those tasks.
+        using kernel = void (*)(size_t const* matrix, size_t machines,
+                size_t first_task, size_t n, size_t const* genes, size_t* loads);
+
+        void accumulate_scalar(size_t const* matrix, size_t const machines,
+                size_t const first_task, size_t const n, size_t const* genes, size_t* loads)
+        {
+            for (size_t t{}; t < n; ++t)
+            {
+                size_t const* row{matrix + (first_task + t) * machines};
+                for (size_t lane{}; lane < width; ++lane)
+                {
+                    auto const m = genes[t * width + lane];
+                    loads[m * width + lane] += row[m];
+                }
+            }
+        }
+
+#ifdef CS340_X86_KERNELS
+        // Four lanes per 256-bit register: gather the run times and the
+        // current loads, add them, and write the four sums back one by one
+        // since AVX2 has no scatter.
+        __attribute__((target("avx2")))
+        void accumulate_avx2(size_t const* matrix, size_t const machines,
+                size_t const first_task, size_t const n, size_t const* genes, size_t* loads)
+        {
+            static_assert(score_batch_width == 8, "two AVX2 registers hold 8 lanes");
+
+            auto const* times = reinterpret_cast<long long const*>(matrix);
+            auto const* current = reinterpret_cast<long long const*>(loads);
+
+            for (size_t t{}; t < n; ++t)
+            {
+                __m256i const row = _mm256_set1_epi64x(static_cast<long long>((first_task + t) * machines));
+
+                for (size_t half{}; half < width; half += 4)
+                {
+                    __m256i const lanes = _mm256_set_epi64x(half + 3, half + 2, half + 1, half);
+                    __m256i const m = _mm256_loadu_si256(
+                            reinterpret_cast<__m256i const*>(genes + t * width + half));
+
+                    __m256i const time = _mm256_i64gather_epi64(times, _mm256_add_epi64(row, m), 8);
+                    __m256i const where = _mm256_add_epi64(_mm256_slli_epi64(m, 3), lanes);
+                    __m256i const sum = _mm256_add_epi64(_mm256_i64gather_epi64(current, where, 8), time);
+
+                    alignas(32) size_t w[4];
+                    alignas(32) size_t s[4];
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(w), where);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(s), sum);
+                    for (size_t k{}; k < 4; ++k)
+                        loads[w[k]] = s[k];
+                }
+            }
+        }
+
+        // All eight lanes in one 512-bit register, with a scatter to write
+        // the sums back.
+        __attribute__((target("avx512f")))
+        void accumulate_avx512(size_t const* matrix, size_t const machines,
+                size_t const first_task, size_t const n, size_t const* genes, size_t* loads)
+        {
+            static_assert(score_batch_width == 8, "one AVX-512 register holds 8 lanes");
+
+            // The masked forms take an explicit source register; the plain
+            // ones start from an undefined one, which GCC warns about at -O0.
+            __m512i const zero = _mm512_setzero_si512();
+            __mmask8 const all{0xFF};
+            __m512i const lanes = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+
+            for (size_t t{}; t < n; ++t)
+            {
+                __m512i const row = _mm512_set1_epi64(static_cast<long long>((first_task + t) * machines));
+                __m512i const m = _mm512_loadu_si512(genes + t * width);
+
+                __m512i const time = _mm512_mask_i64gather_epi64(zero, all, _mm512_add_epi64(row, m), matrix, 8);
+                __m512i const where = _mm512_add_epi64(_mm512_mask_slli_epi64(zero, all, m, 3), lanes);
+                __m512i const sum = _mm512_add_epi64(_mm512_mask_i64gather_epi64(zero, all, where, loads, 8), time);
+                _mm512_i64scatter_epi64(loads, where, sum, 8);
+            }
+        }
+#endif
+
+        struct kernel_choice
+        {
+            kernel accumulate;
+            char const* name;
+        };
+
+        // Pick the widest kernel the CPU supports, once.
+        kernel_choice const& choose_kernel()
+        {
+            static kernel_choice const choice = []() -> kernel_choice
+            {
+#ifdef CS340_X86_KERNELS
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f"))
+                    return { accumulate_avx512, "avx512" };
+                if (__builtin_cpu_supports("avx2"))
+                    return { accumulate_avx2, "avx2" };
+#endif
+                return { accumulate_scalar, "scalar" };
+            }();
+            return choice;
+        }
+
+#ifndef CS340_CHUNKED_SCHEDULE
+        // Score one block of at most width schedules. Missing lanes are
+        // left assigned to machine 0 and their results are ignored.
+        void score_block(runtime_matrix const& matrix, schedule const* const* block,
+                size_t const count, kernel const accumulate,
+                vector<size_t>& genes, vector<size_t>& loads)
+        {
+            auto const tasks = matrix.tasks();
+            auto const machines = matrix.machines();
+
+            vector<size_t> column(tile_size);
+            genes.assign(tile_size * width, 0);
+            loads.assign(machines * width, 0);
+
+            for (size_t first{}; first < tasks; first += tile_size)
+            {
+                auto const n = min(tile_size, tasks - first);
+
+                for (size_t lane{}; lane < count; ++lane)
+                {
+                    block[lane]->copy_task_assignments(first, n, column.data());
+                    for (size_t t{}; t < n; ++t)
+                        genes[t * width + lane] = column[t];
+                }
+
+                accumulate(&matrix(0, 0), machines, first, n, genes.data(), loads.data());
+            }
+
+            for (size_t lane{}; lane < count; ++lane)
+            {
+                size_t total_runtime{};
+                for (size_t m{}; m < machines; ++m)
+                    total_runtime = max(total_runtime, loads[m * width + lane]);
+                block[lane]->cache_makespan(total_runtime);
+            }
+        }
+#endif
+    }
+
+    void score_batch(runtime_matrix const& matrix, schedule const* const* schedules,
+            size_t const count)
+    {
+#ifdef CS340_CHUNKED_SCHEDULE
+        for (size_t i{}; i < count; ++i)
+            schedules[i]->makespan(matrix);
+#else
+        if (matrix.tasks() == 0 || matrix.machines() == 0)
+        {
+            for (size_t i{}; i < count; ++i)
+                schedules[i]->cache_makespan(0);
+            return;
+        }
+
+        auto const accumulate = choose_kernel().accumulate;
+        vector<size_t> genes;
+        vector<size_t> loads;
+
+        for (size_t i{}; i < count; i += width)
+            score_block(matrix, schedules + i, min(width, count - i), accumulate, genes, loads);
+#endif
+    }
+
+    void score_batch(runtime_matrix const& matrix, schedule const* first,
+            schedule const* last)
+    {
+        vector<schedule const*> schedules;
+        schedules.reserve(last - first);
+        for (; first != last; ++first)
+            schedules.push_back(first);
+
+        score_batch(matrix, schedules.data(), schedules.size());
+    }
+
+    char const* score_batch_kernel()
+    {
+        return choose_kernel().name;
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,50 @@
+#ifndef CS340_FITNESS_HXX_
+#define CS340_FITNESS_HXX_
+
+//------------------------------------------------------------------------------
+//
+// This header contains the declarations for scoring many schedules at
+// once.
+//
+// The schedules are scored in blocks of score_batch_width. For every
+// task, the machines the block's schedules assigned it to are turned
+// into one vector of matrix positions, the run times are fetched with a
+// single gather, and added to each schedule's machine loads. On x86-64
+// CPUs with AVX-512 or AVX2 those steps use vector instructions; which
+// kernel is used is decided at runtime from the CPU's features, and a
+// plain scalar kernel is used everywhere else.
+//
+// When built with CS340_CHUNKED_SCHEDULE, schedules already keep
+// per-chunk machine loads, so they are simply scored one at a time.
+//
+//------------------------------------------------------------------------------
+
+#include "types.hxx"
+
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+  // Number of schedules scored together.
+  std::size_t const score_batch_width = 8;
+
+  // Compute the makespans of the given schedules and store them in
+  // their caches, so that later calls to score() and makespan() are
+  // free. The same schedule may appear more than once.
+  void score_batch(runtime_matrix const&, schedule const* const* schedules,
+    std::size_t count);
+
+  // The same for a contiguous range of schedules.
+  void score_batch(runtime_matrix const&, schedule const* first,
+    schedule const* last);
+
+  // The name of the kernel picked for this CPU: "avx512", "avx2" or
+  // "scalar".
+  char const* score_batch_kernel();
+}
+
+//------------------------------------------------------------------------------
+
+#endif
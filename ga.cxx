@@ -12,18 +12,36 @@
 // can have its own RNG (seeded appropriately BEFORE firing off the thread)
 // without introducing data races and other nasty surprises.
 //
+// The generation loop itself lives in the engine class template, which is
+// parameterized on the selection, crossover and mutation policies from
+// operators.hxx. Every combination is instantiated here, and
+// run_simulation() picks the one named in the simulation parameters, so
+// the operators are inlined into the loop instead of being called through
+// a function pointer or a virtual function.
+//
 //------------------------------------------------------------------------------
 
 #include "ga.hxx"
 #include "types.hxx"
+#include "operators.hxx"
+#include "ranked_pool.hxx"
+#include "fitness.hxx"
+#include "enum_names.hxx"
 
 #include <utility>
+#include <string>
+#include <istream>
+#include <ostream>
 #include <random>
 #include <vector>
 #include <algorithm>
 #include <numeric>
 #include <cstddef>
 #include <future>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <cmath>
 
 using namespace std;
 
@@ -57,13 +75,22 @@ namespace cs340
 
         // Populate the gene pool with random values. Each machine in each
         // schedule has equal probability of occuring.
+        //
+        // A pool of schedules from an earlier run can be passed in to warm
+        // start the simulation. Those schedules are kept, and only the
+        // remaining places are filled with random ones. If there are more
+        // of them than pool_size, only the best pool_size are kept.
         auto populate_gene_pool(runtime_matrix const& matrix,
-                size_t const pool_size, random_generator& gen)
+                size_t const pool_size, random_generator& gen,
+                std::vector<schedule> schedule_vector = {})
         {
-            // 1. Create a std::vector of schedules, and use the .reserve()
-            // member function to reserve space for pool_size schedules.
+            // 1. Check that the schedules we were given belong to this
+            // matrix, and reserve space for pool_size schedules.
+
+            for (auto const& s : schedule_vector)
+                if (s.tasks() != matrix.tasks())
+                    throw std::runtime_error("Warm start pool does not match the runtime matrix");
 
-            std::vector<schedule> schedule_vector; 
             schedule_vector.reserve(pool_size);
 
             // 2. Create a std::uniform_int_distribution to sample from. The
@@ -82,12 +109,14 @@ namespace cs340
             // int distribution. (Remember to capture dist, gen, and matrix
             // by reference --not by value.)
 
+            size_t const seeded{schedule_vector.size()};
+
             // Create back_insert_iterator to allow generate_n to use push_back()
             std::back_insert_iterator<std::vector<schedule>> first(schedule_vector);
 
             // Fill schedule_vector with values from lambda
             std::generate_n (first, 
-                    pool_size,
+                    pool_size - std::min(pool_size, schedule_vector.size()),
                     [&distribution, &gen, &matrix]() -> schedule {
 
                     schedule temp(matrix.tasks());
@@ -103,451 +132,539 @@ namespace cs340
             // std::stable_sort, passing in an object of type
             // schedule_compare as the custom comparison operator.
 
-            // Sort the schedule_vector
+            // Score the new schedules in batches first, so that sorting
+            // only ever looks at cached scores.
+            score_batch(matrix, schedule_vector.data() + std::min(seeded, schedule_vector.size()),
+                    schedule_vector.data() + schedule_vector.size());
+
+            // Sort the schedule_vector. This is the only sort the initial
+            // pool gets: the ranked_pool it goes into takes the order as is.
             schedule_compare comparison{matrix};
             std::stable_sort(schedule_vector.begin(), schedule_vector.end(), comparison);   
 
-            // 5. Return the pool of schedules.
+            // 5. Drop the worst schedules if the warm start pool was too big.
+
+            if (schedule_vector.size() > pool_size)
+                schedule_vector.erase(schedule_vector.begin() + pool_size, schedule_vector.end());
+
+            // 6. Return the pool of schedules.
             return schedule_vector;
         }
 
-        // Crossing two schedules over involves selecting a random spot
-        // in the first schedule, and copying everything from the
-        // beginning to that spot into a new schedule. Everything after
-        // that spot is taken from the second schedule. The result is a
-        // new schedule that (hopefully) inherits some of the desirable
-        // traits from the two parents.
-        auto cross_over(schedule c1, schedule const& c2, random_generator& gen)
+        // The genetic algorithm itself. The selection, crossover and
+        // mutation operators are template parameters so that the compiler
+        // can inline them into the generation loop. Only the selection
+        // policy carries state between calls, so each island needs its
+        // own engine.
+        template <typename Selection, typename Crossover, typename Mutation>
+        class engine
         {
-            // 1. Use a uniform_int_distribution to select a random point
-            // in the range [0, c1.tasks() - 1].
+            public:
+            // Run through a single generation of the genetic algorithm.
+            //
+            // First we do crossover to create new schedules. Afterward we
+            // perform random mutations to the genes already in the pool.
+            //
+            // The ranked pool keeps itself in order: inserting a schedule or
+            // re-ranking one after it was mutated takes O(log n), and the
+            // worst schedule is always at hand for removal.
+            //
+            // Returns the number of schedules that were created or changed,
+            // i.e., that will have to be scored.
+            size_t run_single_generation(runtime_matrix const& matrix,
+                    ranked_pool& gene_pool, random_generator& gen)
+            {
+                size_t evaluations{};
 
-            std::uniform_int_distribution<size_t> distribution(0, (c1.tasks()  - 1)); 
+                // Some sane defaults.
+                size_t const min_max_crossovers{(gene_pool.size() / 2) + 1};
+                size_t const min_max_mutations{(gene_pool.size() / 3) + 1};
 
-            // 2. Copy every element from c2, starting at the crossover
-            // point, to c1. This is why we took c1 in by-value: we are copying
-            // its elements and modifying it, to create a new schedule.
+                size_t const max_crossovers{min(size_t{10}, min_max_crossovers)};
+                size_t const max_mutations{min(size_t{25}, min_max_mutations)};
 
-            // Perform crossover between c1 and c2 schedules
-            auto crossover = distribution(gen);
-            for (; crossover < c1.tasks() && crossover < c2.tasks(); ++crossover) {
-                c1.set_task_assignment( crossover, c2.task_assignment(crossover) );
-            }
+                // Initialize the global distribtions.
+                uniform_int_distribution<size_t> x_pairs_dist{0, max_crossovers};
+                uniform_int_distribution<size_t> mut_dist{0, max_mutations};
 
-            // 3. Return the new, modified, c1.
-            return c1;
-        }
 
-        // Randomly change one of the task entries in the schedule.
-        void mutate(runtime_matrix const& matrix, schedule& c,
-                random_generator& gen)
-        {
-            // 1. Pick a random task in the schedule, and a random machine.
-            //
-            // NOTE: Ensure the uniform distribution ranges are correct, e.g.,
-            //       remembering they start at 0.
-            //
-            // Then set the task assignment for the selected machine. Pass in
-            // appropriately generated uniform_int_distribution values for this
-            // call.
-            //
-            // HINT:
-            //   *) You will need to call a member function of schedule to do this.
-            //   *) The randomly generated values will both require using gen.
-
-            // Pick random tasks to mutate randomly
-            std::uniform_int_distribution<std::size_t> distribution_t (0, (c.tasks()  - 1)); 
-            std::uniform_int_distribution<std::size_t> distribution_m (0, (matrix.machines() - 1));
-            c.set_task_assignment(distribution_t(gen), distribution_m(gen));
-        }
+                // 1. Using the x_pairs_dist defined above, generate a random
+                // amount of crossover pairs. Call this variable x_pairs_count.
 
-        // Run through a single generation of the genetic algorithm.
-        //
-        // First we do crossover to create new schedules. Afterward we
-        // perform random mutations to the genes already in the pool.
-        //
-        // ASSUMPTION: The gene pool is in sorted order before calling
-        // this function. Each operation done that modifies or produces
-        // a new schedule ensures that the sorting invariant is
-        // upheld. But that means nothing at all if they aren't sorted
-        // from the get-go. This sorting must happen in the calling code
-        // because we explicitly want to avoid re-sorting the entire
-        // pool every time a change is made.
-        void run_single_generation(runtime_matrix const& matrix,
-                vector<schedule>& gene_pool, random_generator& gen)
-        {
-            // Some sane defaults.
-            size_t const min_max_crossovers{(gene_pool.size() / 2) + 1};
-            size_t const min_max_mutations{(gene_pool.size() / 3) + 1};
-
-            size_t const max_crossovers{min(size_t{10}, min_max_crossovers)};
-            size_t const max_mutations{min(size_t{25}, min_max_mutations)};
-
-            // Initialize the global distribtions.
-            uniform_int_distribution<size_t> x_pairs_dist{0, max_crossovers};
-            uniform_int_distribution<size_t> mut_dist{0, max_mutations};
-
-
-            // 1. Using the x_pairs_dist defined above, generate a random
-            // amount of crossover pairs. Call this variable x_pairs_count.
-
-            size_t x_pairs_count = x_pairs_dist(gen);
-
-            // 2. We will only perform the crossover operations if
-            // the number of pairs is greater than zero, and less than
-            // the size of your gene pool. Write an if-statement to
-            // reflect this condition.
-
-            if ((x_pairs_count < gene_pool.size()) && (x_pairs_count > 0)) {
-
-                // 2a. We need to make space for the new schedules we will
-                // be generating. Create an iterator suitable to be passed into
-                // the .erase() member function of your gene pool, such that
-                // the last N schedules will be removed, where N is the number
-                // of crossover pairs. This is why we maintain the pool in sorted
-                // order!!!
-                //
-                // HINTS:
-                //   *) Create your iterator by first obtaining the first iterator
-                //      from the gene pool.
-                //   *) You will need to adjust the iterator by the gene pool's
-                //      size and x_pairs_count. Do remember std::vector's iterators
-                //      are random-access iterators as this simplifies adjusting
-                //      the iterator position.
-                //   *) Finally erase the last N elements from the gene pool.
-
-                // Use gene_pool size to erase only the last N elements
-                gene_pool.erase(gene_pool.end() - x_pairs_count, gene_pool.end());
+                size_t x_pairs_count = x_pairs_dist(gen);
+
+                // 2. We will only perform the crossover operations if
+                // the number of pairs is greater than zero, and less than
+                // the size of your gene pool. Write an if-statement to
+                // reflect this condition.
 
-                // 2b. Each schedule has a chance of being selected for crossover
-                // directly proportional to its score. In order to efficiently
-                // select these schedules roulette-style, we will sample a random
-                // real number from the range [0, SUM-OF-ALL-SCORES). To do so,
-                // we will create a table of partial sums using std::partial_sum.
-                //
-                // Before doing this, however, we need to create a
-                // vector<double> containing the scores to sum over. Call this
-                // vector totals. After creating the totals vector,
-                // use std::transform to transfom the range
-                // [begin(gene_pool), end(gene_pool)) into a vector of scores.
-                //
-                // HINTS:
-                //   *) Use std::back_inserter on totals to fill totals with
-                //      scores.
-                //   *) Each score is computed by invoking the score() member
-                //      function on each element in the gene pool.
-                //      NOTE: Remember to capture the matrix by reference!
+                if ((x_pairs_count < gene_pool.size()) && (x_pairs_count > 0)) {
 
-                std::vector<double> totals;
-                totals.reserve(gene_pool.size());
+                    evaluations += x_pairs_count;
 
-                // Perform transform to extract scores from every schedule
-                std::transform(begin(gene_pool), 
-                        end(gene_pool), 
-                        std::back_inserter(totals), 
-                        [&matrix](schedule & sch) { return sch.score(matrix); }
-                        );
+                    // 2a. We need to make space for the new schedules we will
+                    // be generating, so remove the N worst schedules, where N
+                    // is the number of crossover pairs.
 
-                // 2c. Now that we have the scores in a new vector, compute the
-                // partial sum of that vector. In order to save space, make the
-                // output iterator for the algorithm be the beginning of your
-                // vector of scores.
+                    for (size_t i{}; i < x_pairs_count; ++i)
+                        gene_pool.erase(gene_pool.worst());
 
-                std::partial_sum(totals.begin(), totals.end(), totals.begin());
+                    // 2b. Let the selection policy look at the pool as it stands
+                    // after the erase, e.g., roulette selection builds its table
+                    // of partial sums of the scores here.
 
-                // 2d. Next we will be selecting x_pairs_count pairs to
-                // cross over.  Start by declaring a
-                // uniform_real_distribution for our roulette-style
-                // selection process. The result type should be double,
-                // and the range must be [0, totals.back()).
+                    select_.prepare(gene_pool);
 
-                uniform_real_distribution<double> distributions_ (0, totals.back());
+                    // 2e. Now write a for loop that will execute x_pairs_count times...
 
-                // 2e. Now write a for loop that will execute x_pairs_count times...
+                    // For each pair to cross over...
+                    for(std::size_t i = 0; i < x_pairs_count; i++) {
 
-                // For each pair to cross over...
-                for(std::size_t i = 0; i < x_pairs_count; i++) {
+                        // 2e i. Ask the selection policy for the handles of the two
+                        // parents in the gene pool.
 
-                    // 2e i. Generate two random numbers from our range.
+                        auto const parent1 = select_(gen);
+                        auto const parent2 = select_(gen);
 
-                    double rand1 = distributions_(gen);
-                    double rand2 = distributions_(gen);
+                        // 2e vi. Create a new schedule object by calling cross_over with
+                        // the two parents.
 
-                    // 2e ii. Using std::lower_bound, find the first value in the
-                    // totals vector that is NOT LESS than the first random number
-                    // you drew.
+                        offspring_.push_back(cross_over_(gene_pool[parent1], gene_pool[parent2], gen));
 
-                    auto val1 = std::lower_bound(totals.begin(), totals.end(), rand1);
+                        // 2f. End of your for-loop. You are now done performing crossover.
 
-                    // 2e iii. Use std::distance to find the offset of the value
-                    // found via lower_bound above. We will use this numeric offset
-                    // to point into to gene_pool vector later...
+                    }   //endfor crossover
 
-                    auto offset1 = std::distance(totals.begin(), val1);
+                    // 2g. Score the new schedules together, then insert them at
+                    // their ranks.
 
-                    // 2e iv. Perform the two above steps again. This time using the
-                    // second random number you drew.
+                    score_batch(matrix, offspring_.data(), offspring_.data() + offspring_.size());
+                    for (auto& child : offspring_)
+                        gene_pool.insert(std::move(child));
+                    offspring_.clear();
 
-                    auto val2 = std::lower_bound(totals.begin(), totals.end(), rand2);
-                    auto offset2 = std::distance(totals.begin(), val2);
+                }   //endif crossover check     (3)
 
-                    // 2e v. Using the two offsets you calculated, find iterators into
-                    // the gene pool corresponding to the random values you drew at the
-                    // top of the loop.
+                // 3. End your if-statement guarding the crossover code.
 
-                    std::vector<schedule>::iterator iterator1 = gene_pool.begin() + offset1;
-                    std::vector<schedule>::iterator iterator2 = gene_pool.begin() + offset2;
+                // 4. Crossover is complete. Now we do mutation. Start by generating
+                // a random size_t from the mut_dist distribution. Call it num_mutations.
 
-                    // 2e vi. Create a new schedule object by calling cross_over with
-                    // the two schedules pointed to by your computed iterators.
-
-                    schedule new_schedule = cross_over(*iterator1, *iterator2, gen);
+                std::size_t num_mutations = mut_dist(gen);
 
-                    // 2e vii. We need to maintain our sorted invariant. Use std::lower_bound
-                    // with an object of type schedule_compare as your custom comparision
-                    // to probe the gene pool for the first schedule that is NOT GREATER
-                    // than the one we just created via crossover.
+                // Determine distribution from gene_pool
+                uniform_int_distribution<std::size_t> m_sel_dist{0, gene_pool.size() - 1};
 
-                    // Insert into gene_pool
-                    schedule_compare comparison{matrix};					
-                    gene_pool.insert(std::lower_bound(gene_pool.begin(), gene_pool.end(), 
-                                new_schedule, 
-                                comparison), 
-                            new_schedule);
+                for (size_t j{}; j < num_mutations; ++j)
+                {
+                    // 4a. Sample a solution to mutate from m_sel_dist.
 
-                    // 2f. End of your for-loop. You are now done performing crossover.
+                    auto const solution = gene_pool.at(m_sel_dist(gen));
 
-                }   //endfor crossover
+                    // 4b. Now that you have the handle of the schedule to mutate,
+                    // hand it to the mutation policy.
 
-            }   //endif crossover check     (3)
+                    mutate_(matrix, gene_pool[solution], gen);
+                    mutated_.push_back(solution);
+                    mutated_schedules_.push_back(&gene_pool[solution]);
+                }
 
-            // 3. End your if-statement guarding the crossover code.
+                // 4c. Score the mutated schedules together, then move each one
+                // to its new rank.
 
-            // 4. Crossover is complete. Now we do mutation. Start by generating
-            // a random size_t from the mut_dist distribution. Call it num_mutations.
+                score_batch(matrix, mutated_schedules_.data(), mutated_schedules_.size());
+                for (auto const h : mutated_)
+                    gene_pool.update(h);
+                mutated_.clear();
+                mutated_schedules_.clear();
 
-            std::size_t num_mutations = mut_dist(gen);
+                return evaluations + num_mutations;
+            }
 
-            // Determine distribution from gene_pool
-            uniform_int_distribution<std::size_t> m_sel_dist{0, gene_pool.size() - 1};
+            private:
+            Selection select_;
+            Crossover cross_over_;
+            Mutation mutate_;
+
+            // Scratch space for the schedules scored together each
+            // generation, kept to reuse its memory.
+            vector<schedule> offspring_;
+            vector<ranked_pool::handle> mutated_;
+            vector<schedule const*> mutated_schedules_;
+        };
 
-            for (size_t j{}; j < num_mutations; ++j)
+        // An island is one independent gene pool, evolved by its own
+        // engine with its own random number generator. Islands are run a
+        // slice of a few generations at a time, so that a handful of
+        // threads can take turns running many more islands than there are
+        // threads. Everything needed to pick up where the last slice left
+        // off is kept here.
+        template <typename Engine>
+        class island
+        {
+            public:
+            island(gene_pool seed_pool, size_t const pool_size,
+                    size_t const generations, std::seed_seq& seq)
+                : seed_pool_(std::move(seed_pool)), pool_size_{pool_size},
+                  generations_left_{generations}, gen_{seq}
             {
-                // 4a. Sample a solution to mutate from m_sel_dist. Do this by
-                // first sampling the distribution, then using the fact that vector's
-                // iterators are random access, find the corresponding solution
-                // by adding the sampled value to begin(gene_pool).
-
-                std::vector<schedule>::iterator solution = begin(gene_pool) + m_sel_dist(gen);
-
-                // 4b. Now that you have the iterator to the schedule to mutate,
-                // call the mutate function you wrote earlier!
-
-                mutate(matrix, *solution, gen);
-
-                // 4c. Similar to the code you wrote previously that computes the
-                // position in the gene pool to insert the crossed-over solution,
-                // do the same with the mutated matrix. First call lower_bound.
-                // Store the resulting iterator in a variable called pos.
-
-                // Find position to insert the solution to mutate
-                schedule_compare comparison{matrix};
-                auto pos = std::lower_bound(gene_pool.begin(), 
-                        gene_pool.end(), 
-                        *solution, 
-                        comparison);
-
-                // 4d. Instead of calling insert, use the algorithm std::rotate
-                // to change the position of the schedule you mutated.
-                //
-                // HINT: You need to call std::rotate differently if pos is greater
-                // than your iterator pointing to the yet-to-be placed mutated schedule.
-
-                // Accomplish an insert using std::rotate()
-                if (pos > solution) 
-                    std::rotate(pos, pos, solution);
-                else 
-                    std::rotate(solution, pos, pos);
             }
+
+            // Run up to the given number of generations. The gene pool is
+            // only populated on the first slice, so that populating it
+            // happens on the worker threads too.
+            //
+            // The island is finished once it runs out of generations or
+            // its best score hasn't changed in time_til_convergence
+            // generations. All islands finish as soon as one of them gets
+            // its best schedule's makespan down to target_makespan: the
+            // shared stop flag is raised, since the overall best is good
+            // enough by then. A target of no_makespan is never reached.
+            //
+            // Returns true once the island is finished.
+            bool run_slice(runtime_matrix const& matrix,
+                    size_t const slice,
+                    size_t const target_makespan,
+                    atomic<bool>& stop,
+                    size_t const time_til_convergence = 30)
+            {
+                if (!populated_) {
+                    evaluations_ += pool_size_ - std::min(pool_size_, seed_pool_.size());
+                    gene_pool_ = ranked_pool{matrix,
+                        populate_gene_pool(matrix, pool_size_, gen_, std::move(seed_pool_))};
+                    populated_ = true;
+
+                    if (!gene_pool_.empty() && reached(matrix, gene_pool_[gene_pool_.best()], target_makespan))
+                        stop = true;
+                }
+
+                if (gene_pool_.empty()) { return true; // Should never happen. 
+                }
+
+                for (size_t i{}; i < slice; ++i) { 
+
+                    if (generations_left_ == 0 || stop.load(memory_order_relaxed))
+                        return true;
+                    --generations_left_;
+
+                    evaluations_ += engine_.run_single_generation(matrix, gene_pool_, gen_);
+                    ++generations_;
+
+                    auto const& best_schedule = gene_pool_[gene_pool_.best()];
+
+                    if (reached(matrix, best_schedule, target_makespan)) {
+                        stop = true;
+                        return true;
+                    }
+
+                    if (best_schedule.score(matrix) > best_) {
+                        best_ = best_schedule.score(matrix);
+                        how_long_unchanged_ = 0;
+                    }
+                    else
+                        ++how_long_unchanged_;
+                    if (how_long_unchanged_ > time_til_convergence) return true;
+                }
+
+                return generations_left_ == 0;
+            }
+
+            // Take the final pool, from best to worst.
+            gene_pool release_pool() { return gene_pool_.release(); }
+            size_t evaluations() const { return evaluations_; }
+            size_t generations() const { return generations_; }
+
+            private:
+            static bool reached(runtime_matrix const& matrix, schedule const& s,
+                    size_t const target_makespan)
+            {
+                return target_makespan != no_makespan && s.makespan(matrix) <= target_makespan;
+            }
+
+            Engine engine_;
+            gene_pool seed_pool_;
+            ranked_pool gene_pool_;
+            size_t pool_size_;
+            size_t generations_left_;
+            random_generator gen_;
+            bool populated_ = false;
+            double best_{};
+            size_t how_long_unchanged_{};
+            size_t evaluations_{};
+            size_t generations_{};
+        };
+
+        // The makespan at which a run may stop early: within args.gap of
+        // the lower bound, e.g., a gap of 0.05 accepts a schedule at most 5%
+        // longer than the bound. No schedule can beat the bound, so with a
+        // gap of zero this only stops runs that are provably optimal. A
+        // negative gap gives no_makespan, i.e., no target at all.
+        size_t target_makespan(runtime_matrix const& matrix,
+                simulation_parameters const& args)
+        {
+            if (args.gap < 0)
+                return no_makespan;
+
+            auto const bound = args.lower_bound != no_makespan
+                ? args.lower_bound : makespan_lower_bound(matrix);
+            return static_cast<size_t>(std::floor(bound * (1 + args.gap)));
         }
 
-        // Run the simulation for a fixed number of generations. The
-        // gene pool is taken in by reference just in case the updates
-        // need to be seen in the calling code.
+        // Run the simulation with one particular combination of genetic
+        // operators. This is the body of run_simulation(), which only has
+        // to pick the right instantiation of this function.
+        //
+        // The pool is split over args.islands islands, which are run by
+        // args.threads threads. The islands wait their turn in a queue: a
+        // thread takes the island at the front, runs one slice of
+        // generations, and puts it at the back unless it is finished.
+        // Finished islands simply drop out, so the threads' time goes to
+        // the islands that are still improving. A thread quits once the
+        // queue is empty, since every island left is then being run by
+        // one of the other threads.
         //
-        // Returns the best schedule seen.
-        auto run_simulation_n_times(runtime_matrix const& matrix,
-                vector<schedule>& gene_pool,
-                size_t const num_generations,
+        // The simulation starts from the schedules in pool, and pool is
+        // replaced with the final (sorted) pool of the simulation.
+        template <typename Engine>
+        schedule run_simulation_with(runtime_matrix const& matrix,
+                simulation_parameters const& args,
                 random_generator& gen,
-                size_t const time_til_convergence = 30)
+                gene_pool& pool,
+                simulation_statistics& stats)
         {
-            double best{};
-            size_t how_long_unchanged{};
+            // 2. One island per thread unless told otherwise, and never
+            // more islands than schedules.
+
+            size_t const num_islands{std::max(size_t{1}, std::min(
+                        args.islands != 0 ? args.islands : args.threads, args.pool_size))};
+            size_t const num_threads{std::min(args.threads, num_islands)};
+
+            // 3. The schedules we were given are dealt out to the islands like
+            // cards, so every island starts with some of the good ones.
+
+            std::vector<gene_pool> island_seeds(num_islands);
+            for (size_t k{}; k < pool.size(); ++k)
+                island_seeds[k % num_islands].push_back(std::move(pool[k]));
+
+            // 4. Each island will get its own random number generator, seeded
+            // by the random number generator in this main thread. First create
+            // a uniform_int_distribution of size_t's, that samples from the range
+            // [0, 100]. We will generate seeds from it for each island.
+
+            std::uniform_int_distribution<std::size_t> dist(0, 100);
+
+            std::vector<island<Engine>> islands;
+            islands.reserve(num_islands);
+
+            for (size_t i{}; i < num_islands; ++i)
+            {
+                // 4a. Now create a vector of size_t objects to store the seeds.
+                // Populate the vector by sampling your distribution six times.
+
+                std::vector<std::size_t> seeds;
+                for (int i = 0; i < 6; ++i) 
+                    seeds.push_back(dist(gen));
+
+                std::seed_seq seq(seeds.begin(), seeds.end());
+
+                // 4b. The pool size is split as evenly as possible.
 
+                size_t const pool_size{args.pool_size / num_islands
+                    + (i < args.pool_size % num_islands ? 1 : 0)};
 
-            if (gene_pool.empty()) { return schedule{}; // Should never happen. 
+                islands.emplace_back(std::move(island_seeds[i]), pool_size,
+                        args.generations, seq);
             }
 
-            for (size_t i{}; i < num_generations; ++i) { 
+            // 5. The queue of islands waiting for a thread. The islands never
+            // move in memory, so the queue only holds their positions.
 
-                run_single_generation(matrix, gene_pool, gen);
+            std::deque<size_t> ready(num_islands);
+            std::iota(ready.begin(), ready.end(), size_t{0});
+            std::mutex ready_mutex;
 
-                auto& best_schedule = gene_pool.front();
+            // All islands stop once any of them is close enough to the
+            // lower bound.
+            size_t const target{target_makespan(matrix, args)};
+            atomic<bool> stop{false};
+
+            size_t const slice{std::max(size_t{1}, args.slice)};
+
+            // This lambda function is what every thread runs. We can safely hold
+            // references to everything since each island is only ever touched by
+            // the thread that took it from the queue, and the rest is read only.
+            auto worker = [&]()
+            {
+                for (;;)
+                {
+                    size_t i;
+                    {
+                        std::lock_guard<std::mutex> lock{ready_mutex};
+                        if (ready.empty())
+                            return;
+                        i = ready.front();
+                        ready.pop_front();
+                    }
 
-                if (best_schedule.score(matrix) > best) {
-                    best = best_schedule.score(matrix);
-                    how_long_unchanged = 0;
+                    if (!islands[i].run_slice(matrix, slice, target, stop))
+                    {
+                        std::lock_guard<std::mutex> lock{ready_mutex};
+                        ready.push_back(i);
+                    }
                 }
-                else
-                    ++how_long_unchanged;
-                if (how_long_unchanged > time_til_convergence) break;
-            }
+            };
 
-            return gene_pool.front();
-        }
-    }
+            // 6. The calling thread is one of the workers, so there is
+            // nothing to fire off when running on a single thread.
 
-    schedule run_simulation(runtime_matrix const& matrix,
-            simulation_parameters const& args,
-            random_generator& gen)
-    {
-        // 1. First we need to check the number of threads.
-        // If the number of threads to use is less than 1, throw
-        // a std::runtime_error exception with the message
-        // "Cannot run on less than 1 thread".
+            std::vector<std::future<void>> workers;
+            for (size_t t{1}; t < num_threads; ++t)
+                workers.push_back(async(launch::async, worker));
+            worker();
+            for (auto& w : workers)
+                w.get();
 
-        if (args.threads < 1) 
-            throw std::runtime_error("Cannot run on less than 1 thread");
+            // 7. Now we need to collect the schedules from our islands. The
+            // front of each pool is that island's winner. Using the
+            // schedule_compare object, if this schedule is better than the
+            // current best one, make it the best one. Then move the whole pool
+            // into the merged pool.
 
+            schedule best{};
+            pool.clear();
+            stats = simulation_statistics{};
 
-        // 2. If the number of threads is 1, then we will run the
-        // simulation without any complex future stuff. First,
-        // write an if-statement to check of the number of threads is 1,
-        // and if true, create a gene pool (by calling populate_gene_pool)
-        // of size args.pool_size. Then call the function run_simulation_n_times
-        // with that gene pool and return the result of that function call.
+            schedule_compare sched = schedule_compare{matrix};
 
-        if (args.threads == 1) {
+            for (auto& isle : islands) {
+                gene_pool winner_pool = isle.release_pool();
 
-            // Should return a vector<schedule>
-            std::vector<schedule> pool = populate_gene_pool(matrix, args.pool_size, gen);
+                // If the winner's score is better than best's, update best
+                if (!winner_pool.empty() && sched(winner_pool.front(), best)) {
+                    best = winner_pool.front();
+                }	
 
-            // Return schedule object
-            return run_simulation_n_times(matrix, pool, args.generations, gen);
-        }
+                std::move(winner_pool.begin(), winner_pool.end(), std::back_inserter(pool));
 
-        // Otherwise, we're running multithreaded code.
+                stats.evaluations += isle.evaluations();
+                stats.generations += isle.generations();
+            }
 
-        // 3. Create a vector to hold objects of type future<schedule>. call it
-        // future_winners. Each thread will run an independent pool of solutions
-        // to the problem and return the best solution. This vector of future schedule
-        // objects will hold the best schedule from each thread.
+            // Keep the merged pool sorted so that it can seed the next run.
+            std::stable_sort(pool.begin(), pool.end(), sched);
 
-        std::vector<std::future<schedule>> future_winners;   
+            // 8. We now have the best schedule of the best schedules. Return it!
+            return best;
+        }
 
-        // 4. Each thread will get its own random number generator, seeded
-        // by the random number generator in this main thread. First create
-        // a uniform_int_distribution of size_t's, that samples from the range
-        // [0, 100]. We will generate seeds from it for each thread.
+        // These three functions turn the runtime choice of operators into
+        // a compile-time one, one template parameter at a time.
+        template <typename Selection, typename Crossover>
+        schedule dispatch_mutation(runtime_matrix const& matrix,
+                simulation_parameters const& args,
+                random_generator& gen,
+                gene_pool& pool,
+                simulation_statistics& stats)
+        {
+            switch (args.mutation)
+            {
+                case mutation_method::random:
+                    return run_simulation_with<engine<Selection, Crossover, random_mutation>>(matrix, args, gen, pool, stats);
+                case mutation_method::swap:
+                    return run_simulation_with<engine<Selection, Crossover, swap_mutation>>(matrix, args, gen, pool, stats);
+                case mutation_method::critical_machine:
+                    return run_simulation_with<engine<Selection, Crossover, critical_machine_mutation>>(matrix, args, gen, pool, stats);
+            }
+            throw std::runtime_error("Unknown mutation method");
+        }
 
-        std::uniform_int_distribution<std::size_t> dist(0, 100);
+        template <typename Selection>
+        schedule dispatch_crossover(runtime_matrix const& matrix,
+                simulation_parameters const& args,
+                random_generator& gen,
+                gene_pool& pool,
+                simulation_statistics& stats)
+        {
+            switch (args.crossover)
+            {
+                case crossover_method::single_point:
+                    return dispatch_mutation<Selection, single_point_crossover>(matrix, args, gen, pool, stats);
+                case crossover_method::two_point:
+                    return dispatch_mutation<Selection, two_point_crossover>(matrix, args, gen, pool, stats);
+                case crossover_method::uniform:
+                    return dispatch_mutation<Selection, uniform_crossover>(matrix, args, gen, pool, stats);
+                case crossover_method::order:
+                    return dispatch_mutation<Selection, order_crossover>(matrix, args, gen, pool, stats);
+            }
+            throw std::runtime_error("Unknown crossover method");
+        }
 
-        for (size_t i{}; i < args.threads; ++i)
+        schedule dispatch_selection(runtime_matrix const& matrix,
+                simulation_parameters const& args,
+                random_generator& gen,
+                gene_pool& pool,
+                simulation_statistics& stats)
         {
-            // 4a. Now create a vector of size_t objects to store the seeds.
-            // Populate the vector by sampling your distribution six times.
-
-            std::vector<std::size_t> seeds;
-            for (int i = 0; i < 6; ++i) 
-                seeds.push_back(dist(gen));
-
-            // 4b. Now we push back into our vector of futures...
-
-            future_winners.push_back(
-                    async(
-                        launch::async,
-                        // This lambda function will execute on a separate thread. We can safely
-                        // hold a reference to the arguments struct and the matrix since they
-                        // will be read from only. We move the seeds vector into the lambda
-                        // (this is a C++14 feature) since they will only be used in the lambda
-                        // body and nowhere else. This saves us a copy.
-                        //
-                        // The return result of the lambda is a schedule object. By passing this
-                        // lambda into std::async, it converts it into a std::future<schedule> that
-                        // we then store in our vector of future schedules.
-
-                        [&matrix, &args, seeds = move(seeds), i]() -> schedule
-                        {
-                        // 4b i. Now turn the vector of seeds into a std::seed_seq by using
-                        // std::seed_seq's iterator constructor.
-
-                        std::seed_seq seq(seeds.begin(), seeds.end());
-
-                        // 4b ii. And then create a random_generator object for this thread.
-                        // Pass in your std::seed_seq object to the generator's constructor.
-
-                        cs340::random_generator thread_gen{seq};
-
-                        // Some constants to help us determine the size of
-                        // this thread's pool.
-                        bool const last_iteration{i == args.threads - 1};
-                        bool const even_split{args.pool_size % args.threads == 0};
-                        size_t const pool_size
-                        {
-                            !last_iteration || even_split
-                                ? args.pool_size / args.threads
-                                : args.pool_size % args.threads
-                        };
-
-                        //  4b iii. Now create a gene pool for this thread by calling
-                        // populate_gene_pool. Pass in the constant pool_size as the
-                        // pool size to create. Pass in the random generator that you created
-                        // for this thread as the generator.
-
-                        std::vector<schedule> thread_pool = 
-                            populate_gene_pool(matrix, pool_size, thread_gen);
-
-                        // 4b iv. Now call run_simulation_n_times with this thread's pool and
-                        // this thread's random generator. Return the result of 
-                        // run_simulation_n_times.
-
-                        // Run the simulation and return the schedule representing it
-                        auto result = run_simulation_n_times(
-                                matrix, 
-                                thread_pool, 
-                                args.generations, 
-                                thread_gen);
-                        return result;
-                        }
-            )
-                );
+            switch (args.selection)
+            {
+                case selection_method::roulette:
+                    return dispatch_crossover<roulette_selection>(matrix, args, gen, pool, stats);
+                case selection_method::tournament:
+                    return dispatch_crossover<tournament_selection<>>(matrix, args, gen, pool, stats);
+                case selection_method::rank:
+                    return dispatch_crossover<rank_selection>(matrix, args, gen, pool, stats);
+            }
+            throw std::runtime_error("Unknown selection method");
         }
 
-        // Now we need to collect the schedules from our threads.
-        schedule best{};
+        // The names of the operators, as used on the command line. The
+        // position in each array matches the enumerator's value.
+        char const* const selection_names[] = { "roulette", "tournament", "rank" };
+        char const* const crossover_names[] = { "single-point", "two-point", "uniform", "order" };
+        char const* const mutation_names[] = { "random", "swap", "critical-machine" };
+    }
 
-        // 5. Write a range-based for-loop over the vector of future winning schedules.
-        // Inside the loop body, create an rvalue-reference to the winning schedule
-        // corresponding to the current future. Use the future schedule's .get()
-        // member function to access this. Then, using the schedule_compare object,
-        // if this schedule is better than the current best one, assign the best one
-        // to the rvalue-reference to the schedule (using std::move).
+    istream& operator >> (istream& is, selection_method& m) { return read_enum_name(is, m, selection_names); }
+    istream& operator >> (istream& is, crossover_method& m) { return read_enum_name(is, m, crossover_names); }
+    istream& operator >> (istream& is, mutation_method& m) { return read_enum_name(is, m, mutation_names); }
 
-        // Each winner is a std::future<schedule>
-        for (auto& winner : future_winners) {
-            schedule winner_schedule = std::move(winner.get());
+    ostream& operator << (ostream& os, selection_method m) { return os << selection_names[static_cast<size_t>(m)]; }
+    ostream& operator << (ostream& os, crossover_method m) { return os << crossover_names[static_cast<size_t>(m)]; }
+    ostream& operator << (ostream& os, mutation_method m) { return os << mutation_names[static_cast<size_t>(m)]; }
 
-            // If winner_schedule.score(matrix) > best.score(matrix), update best
-            schedule_compare sched = schedule_compare{matrix};
+    schedule run_simulation(runtime_matrix const& matrix,
+            simulation_parameters const& args,
+            random_generator& gen,
+            gene_pool& pool,
+            simulation_statistics& stats)
+    {
+        // 1. First we need to check the number of threads.
+        // If the number of threads to use is less than 1, throw
+        // a std::runtime_error exception with the message
+        // "Cannot run on less than 1 thread".
+
+        if (args.threads < 1) 
+            throw std::runtime_error("Cannot run on less than 1 thread");
 
-            if (sched(winner_schedule, best)) {
-                best = std::move(winner_schedule);
-            }	
-        }
 
-        // 6. We now have the best schedule of the best schedules. Return it!
-        return best;
+        return dispatch_selection(matrix, args, gen, pool, stats);
+    }
+
+    schedule run_simulation(runtime_matrix const& matrix,
+            simulation_parameters const& args,
+            random_generator& gen,
+            gene_pool& pool)
+    {
+        simulation_statistics stats;
+        return run_simulation(matrix, args, gen, pool, stats);
+    }
+
+    schedule run_simulation(runtime_matrix const& matrix,
+            simulation_parameters const& args,
+            random_generator& gen)
+    {
+        gene_pool pool;
+        return run_simulation(matrix, args, gen, pool);
     }
 }
 
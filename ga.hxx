@@ -13,23 +13,91 @@
 #include "types.hxx"
 
 #include <cstddef>
+#include <iosfwd>
+#include <limits>
+#include <vector>
 
 namespace cs340 
 {
+  // The genetic operators that can be chosen at runtime. Each one
+  // corresponds to a policy class in operators.hxx. The stream operators
+  // read and write the names used on the command line.
+  enum class selection_method { roulette, tournament, rank };
+  enum class crossover_method { single_point, two_point, uniform, order };
+  enum class mutation_method { random, swap, critical_machine };
+
+  std::istream& operator >> (std::istream&, selection_method&);
+  std::istream& operator >> (std::istream&, crossover_method&);
+  std::istream& operator >> (std::istream&, mutation_method&);
+
+  std::ostream& operator << (std::ostream&, selection_method);
+  std::ostream& operator << (std::ostream&, crossover_method);
+  std::ostream& operator << (std::ostream&, mutation_method);
+
+  // Stands for a makespan that is not known, or not wanted.
+  std::size_t const no_makespan = std::numeric_limits<std::size_t>::max();
+
   // Parameters for a single run of the simulation.
   struct simulation_parameters 
   {
     size_t generations;
     size_t pool_size;
     size_t threads;
+    selection_method selection = selection_method::roulette;
+    crossover_method crossover = crossover_method::single_point;
+    mutation_method mutation = mutation_method::random;
+
+    // Stop as soon as the best makespan is within this fraction of
+    // makespan_lower_bound(), e.g., 0.05 for 5%. A negative gap never
+    // stops early.
+    double gap = 0;
+
+    // Number of independent gene pools (islands) the pool is split into,
+    // and how many generations an island runs before it lets another
+    // island have the thread. Zero islands means one per thread.
+    size_t islands = 0;
+    size_t slice = 10;
+
+    // makespan_lower_bound() of the matrix, for the gap above. It is
+    // computed by run_simulation() when left as no_makespan, so callers
+    // that run many simulations on one matrix should compute it once.
+    size_t lower_bound = no_makespan;
   };
 
+  // What a run of the simulation did, added up over all of its islands.
+  struct simulation_statistics
+  {
+    size_t evaluations = 0;   // Schedules created or changed, i.e., scored.
+    size_t generations = 0;   // Generations run.
+  };
+
+  // A pool of schedules, best first.
+  using gene_pool = std::vector<schedule>;
+
   // Run the genetic algorithm for a specified number of
   // generations. Returns the schedule with the best score after all
   // that.
   schedule run_simulation(runtime_matrix const&,
     simulation_parameters const&,
     random_generator&);
+
+  // As above, but warm started: the initial pool is made of the
+  // schedules in the gene_pool argument, topped up with random ones (or
+  // cut down to the best ones) to get to the requested pool size. When
+  // it returns, the gene_pool holds the final pool of the run, so it can
+  // be passed straight into the next run on the same matrix, e.g., with
+  // a larger pool size or simply to keep improving the same solutions.
+  schedule run_simulation(runtime_matrix const&,
+    simulation_parameters const&,
+    random_generator&,
+    gene_pool&);
+
+  // As above, also reporting what the run did.
+  schedule run_simulation(runtime_matrix const&,
+    simulation_parameters const&,
+    random_generator&,
+    gene_pool&,
+    simulation_statistics&);
 }
 
 //------------------------------------------------------------------------------
@@ -9,9 +9,13 @@
 
 #include "types.hxx"
 #include "ga.hxx"
+#include "etc.hxx"
+#include "study.hxx"
 #include "program_options.hxx"
 
 #include <random>
+#include <fstream>
+#include <stdexcept>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -55,19 +59,68 @@ int main(int argc, char* argv[])
     // 2. The min pool size
     // 3. The number of threads.
     //
+    // followed by the selection, crossover and mutation operators to use
+    // the optimality gap at which to stop, and the number of islands and
+    // generations per time slice.
+    //
     // See the program_options.hxx for the correct member variables of your
     // args object.
 
-    cs340::simulation_parameters params{args.generations, args.min_pool_size, args.threads};
+    cs340::simulation_parameters params{args.generations, args.min_pool_size, args.threads,
+        args.selection, args.crossover, args.mutation, args.gap,
+        args.islands, args.slice};
 
     // 4. Create a matrix object by calling the function
     // cs340::create_random_matrix. Pass in the correct parameters
     // (see types.hxx and types.cxx) for the interface. Use the value
     // 30 for the time_max parameter.
 
-    // Create random matrix using program options
-    auto random_matrix = 
-        cs340::create_random_matrix(args.tasks, args.machines, 30, engine);
+    // Create random matrix using program options. It can also be an ETC
+    // benchmark instance, or be read from a file written by an earlier run.
+    auto random_matrix = [&]
+    {
+        if (!args.matrix_in.empty())
+        {
+            ifstream in{args.matrix_in};
+            if (!in)
+                throw std::runtime_error("Cannot open " + args.matrix_in);
+            return cs340::read_matrix(in);
+        }
+
+        if (args.matrix == cs340::matrix_kind::etc)
+            return cs340::create_etc_matrix(args.tasks, args.machines, args.etc,
+                engine(), args.threads);
+
+        return cs340::create_random_matrix(args.tasks, args.machines, 30, engine);
+    }();
+
+    if (!args.matrix_out.empty())
+    {
+        ofstream out{args.matrix_out};
+        cs340::write_matrix(out, random_matrix);
+        if (!out)
+            throw std::runtime_error("Cannot write " + args.matrix_out);
+    }
+
+    // The lower bound only depends on the matrix, so every run below
+    // shares it. It is only needed to stop early.
+    if (params.gap >= 0)
+        params.lower_bound = cs340::makespan_lower_bound(random_matrix);
+
+    // A study does its own sweep, repeating every point with its own seeds.
+    if (args.study)
+    {
+        cs340::study_parameters study{params, args.study_threads,
+            args.min_pool_size, args.max_pool_size, args.pool_size_step,
+            args.repeats, args.seeds, args.format};
+        cs340::run_study(random_matrix, study, cout);
+        return 0;
+    }
+
+    // With --warm_start, every run is seeded with the final pool of the
+    // run before it, both across pool sizes and across repeated solves
+    // of the same pool size.
+    cs340::gene_pool pool;
 
     cout << "Pool\tResult\tTime (s)\n";
     for ( ;
@@ -92,13 +145,6 @@ int main(int argc, char* argv[])
         //       5a and 5c to determine the total elapsed time of the
         //       simulation.
 
-        auto cpu_time_before = std::chrono::high_resolution_clock::now();
-
-        // Get resulting schedule object from the run_simulation() function
-        auto result = cs340::run_simulation(random_matrix, params, engine);
-
-        auto cpu_time_after = std::chrono::high_resolution_clock::now();
-
         // 6. Output to standard out the following:
         //
         // i. params.pool_size
@@ -112,11 +158,23 @@ int main(int argc, char* argv[])
         // Each field output should be separated by a tab character.
         // The entire output should be flushed via std::endl.
 
-        std::chrono::duration<double> dif = cpu_time_after - cpu_time_before;
+        for (size_t solve{}; solve < args.solves; ++solve)
+        {
+            auto cpu_time_before = std::chrono::high_resolution_clock::now();
+
+            // Get resulting schedule object from the run_simulation() function
+            auto result = args.warm_start
+                ? cs340::run_simulation(random_matrix, params, engine, pool)
+                : cs340::run_simulation(random_matrix, params, engine);
+
+            auto cpu_time_after = std::chrono::high_resolution_clock::now();
+
+            std::chrono::duration<double> dif = cpu_time_after - cpu_time_before;
 
-        // Display information about the resulting schedule object, time stats
-        std::cout << params.pool_size << '\t' << result.score(random_matrix) 
-            << '\t' << dif.count() << std::endl;
+            // Display information about the resulting schedule object, time stats
+            std::cout << params.pool_size << '\t' << result.score(random_matrix) 
+                << '\t' << dif.count() << std::endl;
+        }
     }
 }
 
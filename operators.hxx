@@ -0,0 +1,345 @@
+#ifndef CS340_OPERATORS_HXX_
+#define CS340_OPERATORS_HXX_
+
+//------------------------------------------------------------------------------
+//
+// This header contains the genetic operators used by the simulation.
+// Each operator is a small policy class that the engine in ga.cxx takes
+// as a template parameter, so the chosen operators are known at compile
+// time and get inlined into the generation loop.
+//
+// Selection policies are prepared once per generation with the current
+// ranked gene pool and then return the handle of the parent to use each
+// time they are invoked.
+//
+// Crossover policies take the first parent by value and return it after
+// copying part of the second parent into it.
+//
+// Mutation policies modify a schedule in place.
+//
+//------------------------------------------------------------------------------
+
+#include "types.hxx"
+#include "ranked_pool.hxx"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <utility>
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+  //----------------------------------------------------------------------------
+  // Selection
+  //----------------------------------------------------------------------------
+
+  // Each schedule is selected with a probability directly proportional
+  // to its score. A table of partial sums is built once per generation
+  // and then searched with std::lower_bound.
+  struct roulette_selection
+  {
+    void prepare(ranked_pool const& pool)
+    {
+      handles_.clear();
+      totals_.clear();
+      handles_.reserve(pool.size());
+      totals_.reserve(pool.size());
+
+      for (std::size_t i{}; i < pool.size(); ++i)
+      {
+        handles_.push_back(pool.at(i));
+        totals_.push_back(pool.score(pool.at(i)));
+      }
+      std::partial_sum(begin(totals_), end(totals_), begin(totals_));
+    }
+
+    ranked_pool::handle operator () (random_generator& gen) const
+    {
+      std::uniform_real_distribution<double> dist{0, totals_.back()};
+      auto const pos = std::lower_bound(begin(totals_), end(totals_), dist(gen));
+      return handles_[std::min<std::size_t>(pos - begin(totals_), totals_.size() - 1)];
+    }
+
+  private:
+    std::vector<ranked_pool::handle> handles_;
+    std::vector<double> totals_;
+  };
+
+  // Draw K schedules uniformly and keep the best of them. Larger values
+  // of K increase the selection pressure.
+  template <std::size_t K = 2>
+  struct tournament_selection
+  {
+    static_assert(K > 0, "a tournament needs at least one contestant");
+
+    // Only the schedules in the pool right now take part, even if more
+    // are inserted before the next call to prepare().
+    void prepare(ranked_pool const& pool)
+    {
+      pool_ = &pool;
+      size_ = pool.size();
+    }
+
+    ranked_pool::handle operator () (random_generator& gen) const
+    {
+      std::uniform_int_distribution<std::size_t> dist{0, size_ - 1};
+
+      auto best = pool_->at(dist(gen));
+      for (std::size_t k{1}; k < K; ++k)
+      {
+        auto const challenger = pool_->at(dist(gen));
+        if (pool_->score(challenger) > pool_->score(best))
+          best = challenger;
+      }
+      return best;
+    }
+
+  private:
+    ranked_pool const* pool_ = nullptr;
+    std::size_t size_ = 0;
+  };
+
+  // Linear ranking: the worst schedule has weight 1 and the best has
+  // weight n. The cumulative weights are triangular numbers, so the rank
+  // can be recovered in O(1) and only the handles need to be listed in
+  // rank order.
+  struct rank_selection
+  {
+    void prepare(ranked_pool const& pool)
+    {
+      handles_.clear();
+      handles_.reserve(pool.size());
+      pool.for_each_ranked([this](auto h) { handles_.push_back(h); });
+    }
+
+    ranked_pool::handle operator () (random_generator& gen) const
+    {
+      auto const size = handles_.size();
+      double const n = static_cast<double>(size);
+      std::uniform_real_distribution<double> dist{0, n * (n + 1) / 2};
+
+      // Largest j such that j(j+1)/2 <= u, counted from the worst schedule.
+      auto const j = static_cast<std::size_t>(
+        (std::sqrt(8 * dist(gen) + 1) - 1) / 2);
+      return handles_[size - 1 - std::min(j, size - 1)];
+    }
+
+  private:
+    std::vector<ranked_pool::handle> handles_;
+  };
+
+  //----------------------------------------------------------------------------
+  // Crossover
+  //----------------------------------------------------------------------------
+
+  // Everything from a random point onwards is taken from the second
+  // parent.
+  struct single_point_crossover
+  {
+    schedule operator () (schedule c1, schedule const& c2,
+      random_generator& gen) const
+    {
+      std::uniform_int_distribution<std::size_t> dist{0, c1.tasks() - 1};
+
+      c1.assign_range(c2, dist(gen), std::min(c1.tasks(), c2.tasks()));
+      return c1;
+    }
+  };
+
+  // The segment between two random points is taken from the second
+  // parent.
+  struct two_point_crossover
+  {
+    schedule operator () (schedule c1, schedule const& c2,
+      random_generator& gen) const
+    {
+      auto const tasks = std::min(c1.tasks(), c2.tasks());
+      std::uniform_int_distribution<std::size_t> dist{0, tasks};
+
+      auto first = dist(gen);
+      auto last = dist(gen);
+      if (last < first)
+        std::swap(first, last);
+
+      c1.assign_range(c2, first, last);
+      return c1;
+    }
+  };
+
+  // Every gene is taken from either parent with equal probability. One
+  // 64-bit draw from the generator decides 64 genes.
+  struct uniform_crossover
+  {
+    schedule operator () (schedule c1, schedule const& c2,
+      random_generator& gen) const
+    {
+      auto const tasks = std::min(c1.tasks(), c2.tasks());
+
+      std::uint64_t bits{};
+      for (std::size_t i{}; i < tasks; ++i, bits >>= 1)
+      {
+        if (i % 64 == 0)
+          bits = gen();
+        if (bits & 1)
+          c1.set_task_assignment(i, c2.task_assignment(i));
+      }
+      return c1;
+    }
+  };
+
+  // Order crossover (OX) adapted to our encoding. Since a schedule is
+  // a multiset of machine numbers rather than a permutation, the child
+  // keeps a random segment of the first parent as well as the number of
+  // tasks the first parent assigned to each machine. The remaining
+  // positions are filled with the second parent's genes, in the order
+  // they appear after the segment, skipping machines whose quota has
+  // already been used up.
+  struct order_crossover
+  {
+    schedule operator () (schedule c1, schedule const& c2,
+      random_generator& gen) const
+    {
+      auto const tasks = c1.tasks();
+      if (tasks < 2 || c2.tasks() != tasks)
+        return c1;
+
+      std::uniform_int_distribution<std::size_t> dist{0, tasks};
+      auto first = dist(gen);
+      auto last = dist(gen);
+      if (last < first)
+        std::swap(first, last);
+
+      // Machines still to be handed out outside of the kept segment.
+      std::vector<std::size_t> quota;
+      for (std::size_t i{}; i < tasks; ++i)
+      {
+        auto const m = c1.task_assignment(i);
+        if (m >= quota.size())
+          quota.resize(m + 1);
+        if (i < first || i >= last)
+          ++quota[m];
+      }
+
+      // Fill the positions after the segment (wrapping around) with the
+      // second parent's genes read from the same starting point.
+      std::size_t src{};
+      for (std::size_t n{}; n < tasks - (last - first); ++n)
+      {
+        auto m = quota.size();
+        while (src < tasks && m == quota.size())
+        {
+          auto const g = c2.task_assignment((last + src++) % tasks);
+          if (g < quota.size() && quota[g] > 0)
+            m = g;
+        }
+
+        // The second parent ran out of usable genes, so hand out
+        // whatever is left of the quota.
+        if (m == quota.size())
+          m = std::find_if(begin(quota), end(quota),
+            [](auto q) { return q > 0; }) - begin(quota);
+
+        --quota[m];
+        c1.set_task_assignment((last + n) % tasks, m);
+      }
+      return c1;
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  // Mutation
+  //----------------------------------------------------------------------------
+
+  // Assign one random task to a random machine.
+  struct random_mutation
+  {
+    void operator () (runtime_matrix const& matrix, schedule& c,
+      random_generator& gen) const
+    {
+      std::uniform_int_distribution<std::size_t> task_dist{0, c.tasks() - 1};
+      std::uniform_int_distribution<std::size_t> machine_dist{0, matrix.machines() - 1};
+      c.set_task_assignment(task_dist(gen), machine_dist(gen));
+    }
+  };
+
+  // Exchange the machines of two random tasks.
+  struct swap_mutation
+  {
+    void operator () (runtime_matrix const&, schedule& c,
+      random_generator& gen) const
+    {
+      std::uniform_int_distribution<std::size_t> task_dist{0, c.tasks() - 1};
+
+      auto const a = task_dist(gen);
+      auto const b = task_dist(gen);
+      auto const ma = c.task_assignment(a);
+      auto const mb = c.task_assignment(b);
+      if (ma == mb)
+        return;
+
+      c.set_task_assignment(a, mb);
+      c.set_task_assignment(b, ma);
+    }
+  };
+
+  // Move a random task off the machine that determines the makespan,
+  // onto whichever machine would then finish it the earliest.
+  struct critical_machine_mutation
+  {
+    void operator () (runtime_matrix const& matrix, schedule& c,
+      random_generator& gen) const
+    {
+      auto const machines = matrix.machines();
+      if (machines < 2 || c.tasks() == 0)
+        return;
+
+      std::vector<std::size_t> loads(machines);
+      for (std::size_t t{}; t < c.tasks(); ++t)
+        loads[c.task_assignment(t)] += matrix(t, c.task_assignment(t));
+
+      auto const critical = static_cast<std::size_t>(
+        std::max_element(begin(loads), end(loads)) - begin(loads));
+
+      // Reservoir-sample one of the tasks on the critical machine.
+      std::size_t task{c.tasks()};
+      std::size_t seen{};
+      for (std::size_t t{}; t < c.tasks(); ++t)
+      {
+        if (c.task_assignment(t) != critical)
+          continue;
+        std::uniform_int_distribution<std::size_t> dist{0, seen++};
+        if (dist(gen) == 0)
+          task = t;
+      }
+      if (task == c.tasks())
+        return;
+
+      std::size_t target{critical};
+      auto best = loads[critical];
+      for (std::size_t m{}; m < machines; ++m)
+      {
+        if (m == critical)
+          continue;
+        auto const finish = loads[m] + matrix(task, m);
+        if (finish < best)
+        {
+          best = finish;
+          target = m;
+        }
+      }
+
+      if (target != critical)
+        c.set_task_assignment(task, target);
+    }
+  };
+}
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -7,6 +7,10 @@
 //
 //------------------------------------------------------------------------------
 
+#include "ga.hxx"
+#include "etc.hxx"
+#include "study.hxx"
+
 #include <random>
 #include <vector>
 #include <cstddef>
@@ -32,6 +36,22 @@ namespace cs340
     std::size_t machines;             // Number of machines to schedule tasks to.
     std::size_t generations;          // Number of generations.
     std::size_t threads;              // Number of threads to use to run the sim.
+    std::size_t solves;               // Number of runs for each pool size.
+    bool warm_start;                  // Seed each run with the previous run's pool.
+    selection_method selection;       // How parents are chosen for crossover.
+    crossover_method crossover;       // How two parents are combined.
+    mutation_method mutation;         // How a schedule is mutated.
+    double gap;                       // Stop within this fraction of the lower bound.
+    std::size_t islands;              // Number of islands to split the pool into.
+    std::size_t slice;                // Generations an island runs per turn.
+    matrix_kind matrix;               // Kind of runtime matrix to generate.
+    etc_parameters etc;               // Class of ETC matrix to generate.
+    std::string matrix_in;            // File to read the matrix from instead.
+    std::string matrix_out;           // File to write the matrix to.
+    bool study;                       // Run a scaling study instead.
+    std::vector<std::size_t> study_threads; // Thread counts to study.
+    std::size_t repeats;              // Runs per point of the study.
+    study_format format;              // How to report the study.
   };
 
   program_options::program_options(int argc, char* argv[])
@@ -40,6 +60,7 @@ namespace cs340
     namespace po = boost::program_options;
 
     string seed_string;
+    string study_threads_string;
 
     po::options_description desc{"Available options"};
     desc.add_options()
@@ -68,6 +89,60 @@ namespace cs340
       ("threads",
         po::value<size_t>(&threads)->default_value(1),
         "number of CPU threads to use")
+      ("solves",
+        po::value<size_t>(&solves)->default_value(1),
+        "number of times to run the sim for each pool size")
+      ("warm_start",
+        po::bool_switch(&warm_start),
+        "start each run from the final pool of the previous run")
+      ("selection",
+        po::value<selection_method>(&selection)->default_value(selection_method::roulette, "roulette"),
+        "parent selection: roulette, tournament or rank")
+      ("crossover",
+        po::value<crossover_method>(&crossover)->default_value(crossover_method::single_point, "single-point"),
+        "crossover: single-point, two-point, uniform or order")
+      ("mutation",
+        po::value<mutation_method>(&mutation)->default_value(mutation_method::random, "random"),
+        "mutation: random, swap or critical-machine")
+      ("gap",
+        po::value<double>(&gap)->default_value(0),
+        "stop once the makespan is within this fraction of its lower bound")
+      ("islands",
+        po::value<size_t>(&islands)->default_value(0),
+        "number of islands to split the pool into (0 = one per thread)")
+      ("slice",
+        po::value<size_t>(&slice)->default_value(10),
+        "generations an island runs before another island gets the thread")
+      ("matrix",
+        po::value<matrix_kind>(&matrix)->default_value(matrix_kind::uniform, "uniform"),
+        "runtime matrix to generate: uniform or etc")
+      ("consistency",
+        po::value<etc_consistency>(&etc.consistency)->default_value(etc_consistency::inconsistent, "inconsistent"),
+        "ETC matrix consistency: consistent, semi-consistent or inconsistent")
+      ("task_heterogeneity",
+        po::value<etc_heterogeneity>(&etc.task_heterogeneity)->default_value(etc_heterogeneity::high, "high"),
+        "ETC matrix task heterogeneity: low or high")
+      ("machine_heterogeneity",
+        po::value<etc_heterogeneity>(&etc.machine_heterogeneity)->default_value(etc_heterogeneity::high, "high"),
+        "ETC matrix machine heterogeneity: low or high")
+      ("matrix_in",
+        po::value<string>(&matrix_in),
+        "read the runtime matrix from this file instead of generating it")
+      ("matrix_out",
+        po::value<string>(&matrix_out),
+        "write the runtime matrix to this file")
+      ("study",
+        po::bool_switch(&study),
+        "run a scaling study over thread counts and pool sizes")
+      ("study_threads",
+        po::value<string>(&study_threads_string)->default_value("1,2,4,8"),
+        "thread counts to study: comma-separated positive integers")
+      ("repeats",
+        po::value<size_t>(&repeats)->default_value(5),
+        "number of independently seeded runs per point of the study")
+      ("format",
+        po::value<study_format>(&format)->default_value(study_format::csv, "csv"),
+        "study report format: csv or json")
       ;
 
     po::variables_map vm;
@@ -90,6 +165,16 @@ namespace cs340
       seeds.push_back(stoi(seed));
     }
 
+    // Parse the study's thread counts the same way.
+    stringstream ts{study_threads_string};
+    while (ts.good()) 
+    {
+      string threads;
+      getline(ts, threads, ',');
+      if (threads.empty()) continue;
+      study_threads.push_back(stoi(threads));
+    }
+
     if (seeds.empty()) 
     {
       // Randomly selected.
@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+//
+// This file contains the definitions for the member functions of the
+// ranked gene pool.
+//
+//------------------------------------------------------------------------------
+
+#include "ranked_pool.hxx"
+#include "types.hxx"
+
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+    ranked_pool::ranked_pool(runtime_matrix const& matrix, vector<schedule> pool)
+        : matrix_{&matrix}
+    {
+        slots_.reserve(pool.size());
+        where_.reserve(pool.size());
+        live_index_.reserve(pool.size());
+        live_.reserve(pool.size());
+
+        // When the pool is sorted, every key belongs at the end of the
+        // ranking, so the hint makes each insertion constant time.
+        for (auto& s : pool)
+        {
+            auto const h = take_slot(std::move(s));
+            where_[h] = ranking_.insert(ranking_.end(), make_key(h));
+        }
+    }
+
+    ranked_pool::handle ranked_pool::insert(schedule s)
+    {
+        auto const h = take_slot(std::move(s));
+        where_[h] = ranking_.insert(make_key(h)).first;
+        return h;
+    }
+
+    ranked_pool::handle ranked_pool::take_slot(schedule s)
+    {
+        handle h;
+        if (free_.empty())
+        {
+            h = slots_.size();
+            slots_.push_back(std::move(s));
+            where_.emplace_back();
+            live_index_.emplace_back();
+        }
+        else
+        {
+            h = free_.back();
+            free_.pop_back();
+            slots_[h] = std::move(s);
+        }
+
+        live_index_[h] = live_.size();
+        live_.push_back(h);
+        return h;
+    }
+
+    ranked_pool::key ranked_pool::make_key(handle h)
+    {
+        return key{slots_[h].score(*matrix_), sequence_++, h};
+    }
+
+    void ranked_pool::erase(handle h)
+    {
+        ranking_.erase(where_[h]);
+
+        // Move the last live handle into the erased one's place.
+        auto const i = live_index_[h];
+        live_[i] = live_.back();
+        live_index_[live_[i]] = i;
+        live_.pop_back();
+
+        // Let go of the schedule's memory now rather than on reuse.
+        slots_[h] = schedule{};
+        free_.push_back(h);
+    }
+
+    void ranked_pool::update(handle h)
+    {
+        ranking_.erase(where_[h]);
+        where_[h] = ranking_.insert(make_key(h)).first;
+    }
+
+    vector<schedule> ranked_pool::release()
+    {
+        vector<schedule> pool;
+        pool.reserve(size());
+        for (auto const& k : ranking_)
+            pool.push_back(std::move(slots_[k.h]));
+
+        slots_.clear();
+        where_.clear();
+        live_index_.clear();
+        live_.clear();
+        free_.clear();
+        ranking_.clear();
+        return pool;
+    }
+}
+
+//------------------------------------------------------------------------------
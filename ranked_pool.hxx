@@ -0,0 +1,135 @@
+#ifndef CS340_RANKED_POOL_HXX_
+#define CS340_RANKED_POOL_HXX_
+
+//------------------------------------------------------------------------------
+//
+// This header contains the gene pool used while the simulation runs.
+//
+// The schedules themselves never move: each one sits in a slot and is
+// referred to by a handle, which is the slot's number. The order of the
+// pool is kept separately, in a balanced tree of (score, handle) keys.
+// That way a schedule that was changed in place can be moved to its new
+// rank in O(log n), without shifting any schedules around, and the best
+// and worst schedules can be looked up in O(1).
+//
+// Schedules with equal scores are ranked in the order they were put in
+// (or last updated).
+//
+//------------------------------------------------------------------------------
+
+#include "types.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+  class ranked_pool
+  {
+  public:
+    using handle = std::size_t;
+
+    ranked_pool() = default;
+
+    // Take over the schedules, which are scored with the matrix. The
+    // matrix must outlive the pool. Schedules already sorted from best
+    // to worst (with stable ties) are ranked in linear time; any other
+    // order works too, but costs O(n log n).
+    ranked_pool(runtime_matrix const&, std::vector<schedule>);
+
+    ranked_pool(ranked_pool const&) = delete;
+    ranked_pool(ranked_pool&&) = default;
+
+    ranked_pool& operator = (ranked_pool const&) = delete;
+    ranked_pool& operator = (ranked_pool&&) = default;
+
+    ~ranked_pool() = default;
+
+    std::size_t size() const { return live_.size(); }
+    bool empty() const { return live_.empty(); }
+
+    // Access a schedule. After changing a schedule through the
+    // non-const overload, call update() to move it to its new rank.
+    schedule const& operator [] (handle h) const { return slots_[h]; }
+    schedule& operator [] (handle h) { return slots_[h]; }
+
+    // The score the schedule is currently ranked by.
+    double score(handle h) const { return where_[h]->score; }
+
+    // The best and worst ranked schedules. The pool must not be empty.
+    handle best() const { return ranking_.begin()->h; }
+    handle worst() const { return std::prev(ranking_.end())->h; }
+
+    // The i-th schedule in the pool, for i in [0, size()), in no
+    // particular order. This is for picking schedules uniformly at
+    // random. Inserting does not change the handles of the schedules
+    // already in the pool; erasing does.
+    handle at(std::size_t i) const { return live_[i]; }
+
+    // Add a schedule to the pool, returning its handle.
+    handle insert(schedule);
+
+    // Remove a schedule from the pool. Its handle may be reused.
+    void erase(handle);
+
+    // Re-rank a schedule after it was changed.
+    void update(handle);
+
+    // Call f with every handle, from the best schedule to the worst.
+    template <typename F>
+    void for_each_ranked(F f) const
+    {
+      for (auto const& k : ranking_)
+        f(k.h);
+    }
+
+    // Empty the pool, returning its schedules from best to worst.
+    std::vector<schedule> release();
+
+  private:
+    struct key
+    {
+      double score;
+      std::uint64_t sequence;
+      handle h;
+    };
+
+    // Best (highest score) first, then oldest first.
+    struct key_compare
+    {
+      bool operator () (key const& a, key const& b) const
+      {
+        if (a.score != b.score)
+          return a.score > b.score;
+        return a.sequence < b.sequence;
+      }
+    };
+
+    using ranking = std::set<key, key_compare>;
+
+    // Put a schedule in a free slot and mark it live, without ranking it.
+    handle take_slot(schedule);
+
+    // A new key for the schedule's current score, ranked after every
+    // other schedule with the same score.
+    key make_key(handle);
+
+    runtime_matrix const* matrix_ = nullptr;
+    std::vector<schedule> slots_;
+    std::vector<ranking::iterator> where_;   // Each slot's key.
+    std::vector<std::size_t> live_index_;    // Each slot's position in live_.
+    std::vector<handle> live_;               // The slots in use.
+    std::vector<handle> free_;               // The slots not in use.
+    ranking ranking_;
+    std::uint64_t sequence_ = 0;
+  };
+}
+
+//------------------------------------------------------------------------------
+
+#endif
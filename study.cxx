@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+//
+// This file contains the definitions for the scaling study.
+//
+//------------------------------------------------------------------------------
+
+#include "study.hxx"
+#include "types.hxx"
+#include "ga.hxx"
+#include "enum_names.hxx"
+#include "fitness.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+    namespace
+    {
+        char const* const format_names[] = { "csv", "json" };
+
+        // The results of all of the repeats of one point of the study.
+        struct point_results
+        {
+            vector<double> seconds;
+            vector<double> makespans;
+            size_t evaluations = 0;
+        };
+
+        // Median of a sorted, non-empty vector.
+        double median(vector<double> const& v)
+        {
+            auto const n = v.size();
+            return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+        }
+
+        // Nearest-rank percentile of a sorted, non-empty vector.
+        double percentile(vector<double> const& v, double const p)
+        {
+            auto const rank = static_cast<size_t>(std::ceil(p * v.size()));
+            return v[std::max(rank, size_t{1}) - 1];
+        }
+
+        // Run every repeat of one point of the study.
+        point_results run_point(runtime_matrix const& matrix,
+                study_parameters const& study,
+                simulation_parameters const& params)
+        {
+            point_results results;
+
+            for (size_t r{}; r < study.repeats; ++r)
+            {
+                // Every point uses the same seeds for its r-th repeat, so the
+                // thread counts are compared on the same runs.
+                vector<size_t> seeds{study.seeds};
+                seeds.push_back(r);
+                seed_seq seq(begin(seeds), end(seeds));
+                random_generator gen{seq};
+
+                gene_pool pool;
+                simulation_statistics stats;
+
+                auto const before = chrono::steady_clock::now();
+                auto const best = run_simulation(matrix, params, gen, pool, stats);
+                auto const after = chrono::steady_clock::now();
+
+                results.seconds.push_back(chrono::duration<double>(after - before).count());
+                results.makespans.push_back(static_cast<double>(best.makespan(matrix)));
+                results.evaluations += stats.evaluations;
+            }
+
+            sort(begin(results.seconds), end(results.seconds));
+            sort(begin(results.makespans), end(results.makespans));
+            return results;
+        }
+    }
+
+    istream& operator >> (istream& is, study_format& f)
+    {
+        return read_enum_name(is, f, format_names);
+    }
+
+    ostream& operator << (ostream& os, study_format f)
+    {
+        return os << format_names[static_cast<size_t>(f)];
+    }
+
+    void run_study(runtime_matrix const& matrix, study_parameters const& study,
+            ostream& os)
+    {
+        if (study.repeats < 1)
+            throw std::runtime_error("A study needs at least 1 repeat");
+        if (study.thread_counts.empty())
+            throw std::runtime_error("A study needs at least 1 thread count");
+        if (study.pool_size_step < 1)
+            throw std::runtime_error("A study needs a pool size step of at least 1");
+
+        // Speedup is measured against the smallest thread count.
+        vector<size_t> thread_counts{study.thread_counts};
+        sort(begin(thread_counts), end(thread_counts));
+        thread_counts.erase(unique(begin(thread_counts), end(thread_counts)), end(thread_counts));
+
+        // Every thread count runs the same islands, or else the points
+        // would be different runs of the GA rather than the same runs on
+        // more threads.
+        size_t const islands{study.simulation.islands != 0
+            ? study.simulation.islands : thread_counts.back()};
+
+        char const* const kernel{score_batch_kernel()};
+
+        bool const csv{study.format == study_format::csv};
+        bool first_point{true};
+
+        if (csv)
+            os << "threads,islands,pool_size,repeats,median_s,p95_s,evaluations_per_s,"
+                "speedup,efficiency,best_makespan,median_makespan,worst_makespan,kernel\n";
+        else
+            os << "[";
+
+        for (auto pool_size = study.min_pool_size;
+                pool_size <= study.max_pool_size;
+                pool_size += study.pool_size_step)
+        {
+            double baseline{};
+
+            for (auto const threads : thread_counts)
+            {
+                simulation_parameters params{study.simulation};
+                params.pool_size = pool_size;
+                params.threads = threads;
+                params.islands = islands;
+
+                auto const results = run_point(matrix, study, params);
+
+                double const median_s{median(results.seconds)};
+                double const p95_s{percentile(results.seconds, 0.95)};
+
+                double total_s{};
+                for (auto const s : results.seconds)
+                    total_s += s;
+
+                double const evaluations_per_s{total_s > 0 ? results.evaluations / total_s : 0};
+
+                if (threads == thread_counts.front())
+                    baseline = median_s;
+
+                double const speedup{median_s > 0 ? baseline / median_s : 0};
+                double const efficiency{speedup * thread_counts.front() / threads};
+
+                if (csv)
+                {
+                    os << threads << ',' << islands << ',' << pool_size << ',' << study.repeats << ','
+                        << median_s << ',' << p95_s << ',' << evaluations_per_s << ','
+                        << speedup << ',' << efficiency << ','
+                        << results.makespans.front() << ',' << median(results.makespans) << ','
+                        << results.makespans.back() << ',' << kernel << endl;
+                }
+                else
+                {
+                    os << (first_point ? "\n" : ",\n")
+                        << "  { \"threads\": " << threads
+                        << ", \"islands\": " << islands
+                        << ", \"pool_size\": " << pool_size
+                        << ", \"repeats\": " << study.repeats
+                        << ", \"median_s\": " << median_s
+                        << ", \"p95_s\": " << p95_s
+                        << ", \"evaluations_per_s\": " << evaluations_per_s
+                        << ", \"speedup\": " << speedup
+                        << ", \"efficiency\": " << efficiency
+                        << ", \"best_makespan\": " << results.makespans.front()
+                        << ", \"median_makespan\": " << median(results.makespans)
+                        << ", \"worst_makespan\": " << results.makespans.back()
+                        << ", \"kernel\": \"" << kernel << '"'
+                        << " }" << flush;
+                }
+                first_point = false;
+            }
+        }
+
+        if (!csv)
+            os << "\n]" << endl;
+    }
+}
+
+//------------------------------------------------------------------------------
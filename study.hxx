@@ -0,0 +1,64 @@
+#ifndef CS340_STUDY_HXX_
+#define CS340_STUDY_HXX_
+
+//------------------------------------------------------------------------------
+//
+// This header contains the declarations for the scaling study. A study
+// runs the simulation for every combination of thread count and pool
+// size, several times each with independent seeds, and reports the
+// distribution of the run times and results instead of a single run.
+//
+// For every point it reports:
+//
+// * the number of islands the pool was split into,
+// * the median and 95th percentile of the wall-clock time,
+// * the number of schedules evaluated per second,
+// * the speedup and parallel efficiency relative to the smallest
+//   thread count in the study,
+// * the best, median and worst of the makespans found, and
+// * the kernel used to score schedules (see fitness.hxx), so that
+//   results from CPUs with different vector units can be told apart.
+//
+//------------------------------------------------------------------------------
+
+#include "types.hxx"
+#include "ga.hxx"
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace cs340
+{
+  enum class study_format { csv, json };
+
+  std::istream& operator >> (std::istream&, study_format&);
+  std::ostream& operator << (std::ostream&, study_format);
+
+  // Parameters for a study. The threads member of the simulation
+  // parameters is ignored in favour of thread_counts. So that only the
+  // number of threads changes between the points of one pool size, zero
+  // islands (one per thread) means as many islands as the largest
+  // thread count, for every thread count.
+  struct study_parameters
+  {
+    simulation_parameters simulation;
+    std::vector<std::size_t> thread_counts;
+    std::size_t min_pool_size;
+    std::size_t max_pool_size;
+    std::size_t pool_size_step;
+    std::size_t repeats;
+    std::vector<std::size_t> seeds;   // Repeat r is seeded with these and r.
+    study_format format;
+  };
+
+  // Run the study on the given matrix and write the report to the
+  // stream, one point at a time as they are finished.
+  void run_study(runtime_matrix const&, study_parameters const&, std::ostream&);
+}
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -73,6 +73,74 @@ namespace cs340
         return matrix;
     }
 
+#ifdef CS340_CHUNKED_SCHEDULE
+    constexpr std::size_t schedule::chunk_size;
+
+    schedule::schedule(std::size_t sz)
+        : tasks_{sz}
+    {
+        chunks_.reserve((sz + chunk_size - 1) / chunk_size);
+        for (size_t first = 0; first < sz; first += chunk_size)
+        {
+            auto const n = std::min<std::size_t>(chunk_size, sz - first);
+            chunks_.push_back(std::make_shared<chunk>(std::vector<std::size_t>(n)));
+        }
+    }
+
+    // Whole chunks inside the range are shared with the other schedule
+    // instead of copied. Only the chunks at either end of the range, if
+    // they are not entirely inside it, are copied task by task.
+    void schedule::assign_range(schedule const& other, size_t first, size_t last)
+    {
+        while (first < last)
+        {
+            auto const k = first / chunk_size;
+            auto const chunk_end = std::min<std::size_t>((k + 1) * chunk_size, tasks_);
+
+            if (first == k * chunk_size && last >= chunk_end)
+            {
+                if (chunks_[k] != other.chunks_[k])
+                {
+                    chunks_[k] = other.chunks_[k];
+                    has_cache_ = false;
+                }
+                first = chunk_end;
+                continue;
+            }
+
+            for (auto const end = std::min(last, chunk_end); first < end; ++first)
+                if (task_assignment(first) != other.task_assignment(first))
+                    set_task_assignment(first, other.task_assignment(first));
+        }
+    }
+
+    void schedule::copy_task_assignments(size_t first, size_t count, size_t* out) const
+    {
+        while (count > 0)
+        {
+            auto const& genes = chunks_[first / chunk_size]->genes;
+            auto const offset = first % chunk_size;
+            auto const n = std::min(count, genes.size() - offset);
+
+            out = std::copy_n(genes.begin() + offset, n, out);
+            first += n;
+            count -= n;
+        }
+    }
+#else
+    void schedule::assign_range(schedule const& other, size_t first, size_t last)
+    {
+        std::copy(begin(other.data_) + first, begin(other.data_) + last,
+                begin(data_) + first);
+        has_cache_ = false;
+    }
+
+    void schedule::copy_task_assignments(size_t first, size_t count, size_t* out) const
+    {
+        std::copy_n(begin(data_) + first, count, out);
+    }
+#endif
+
     // We compute the score of each schedule via it's makespan.  The
     // makespan of a schedule is simply the total time from start to
     // finish. In our case, that means the makespan is the maximum time
@@ -91,13 +159,54 @@ namespace cs340
         if ( tasks() == 0 )
             return 0;
 
-        // 2. Check if we already have a cached score. If so,
-        // return the score we've cached. (See the class declaration
+        // 2. Computing the makespan also computes and caches the score.
+
+        makespan(matrix);
+        return cached_score_;
+    }
+
+    size_t schedule::makespan(runtime_matrix const& matrix) const
+    {
+        if ( tasks() == 0 )
+            return 0;
+
+        // Check if we already have a cached makespan. If so,
+        // return the makespan we've cached. (See the class declaration
         // in types.hxx.)
 
         if (has_cache_)
-            return cached_score_;
+            return cached_makespan_;
+
+#ifdef CS340_CHUNKED_SCHEDULE
+        // Each chunk knows how much time its tasks add to each machine.
+        // Only the chunks that changed since they were last looked at
+        // have to go through the matrix, the rest are simply added up.
+
+        std::vector<std::size_t> loads(matrix.machines());
+
+        for (size_t k = 0; k < chunks_.size(); ++k)
+        {
+            chunk const& c = *chunks_[k];
 
+            if (!c.has_loads.load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> lock{c.loads_mutex};
+                if (!c.has_loads.load(std::memory_order_relaxed))
+                {
+                    c.loads.assign(matrix.machines(), 0);
+                    for (size_t j = 0; j < c.genes.size(); ++j)
+                        c.loads[c.genes[j]] += matrix(k * chunk_size + j, c.genes[j]);
+                    c.has_loads.store(true, std::memory_order_release);
+                }
+            }
+
+            for (size_t m = 0; m < loads.size(); ++m)
+                loads[m] += c.loads[m];
+        }
+
+        auto const total_runtime = *std::max_element(begin(loads), end(loads));
+
+#else
         // 3. We need to compute the score. First, create an object
         // of type std::multimap<std::size_t, std::size_t>, which
         // will map machines to the tasks that will run on it (as dictated
@@ -151,11 +260,12 @@ namespace cs340
             //      to m(i,j).
 
             // Compute total runtime for current machine
-            std::size_t total_runtime_machine = std::accumulate(range.first, range.second, 0,
+            std::size_t total_runtime_machine = std::accumulate(range.first, range.second, std::size_t{0},
                     [&matrix](auto const & a, auto const & b) -> std::size_t {
 
-                    // Add accumulated (a) to next (matrix)
-                    return a + matrix(b.first, b.second);
+                    // Add accumulated (a) to next (matrix). Each element is a
+                    // (machine, task) pair, and RT[i,j] is indexed by task first.
+                    return a + matrix(b.second, b.first);
                     });
 
             // 7. Using std::max, update the total_runtime variable declared
@@ -167,6 +277,8 @@ namespace cs340
 
 
 
+#endif
+
         // 8. Now compute the cached score by using the following
         // formula:
         //
@@ -178,10 +290,39 @@ namespace cs340
         // Calculate cached score
         // NOTE: Must use float (1.0) to force implicit conversion
         cached_score_ = 1.0 / (total_runtime + 1) * 1000;
+        cached_makespan_ = total_runtime;
         has_cache_ = true;
 
-        // 9. Finally, return the cached score you computed.
-        return cached_score_;
+        // 9. Finally, return the makespan you computed.
+        return cached_makespan_;
+    }
+
+    void schedule::cache_makespan(size_t const total_runtime) const
+    {
+        cached_score_ = 1.0 / (total_runtime + 1) * 1000;
+        cached_makespan_ = total_runtime;
+        has_cache_ = true;
+    }
+
+    size_t makespan_lower_bound(runtime_matrix const& matrix)
+    {
+        if (matrix.tasks() == 0 || matrix.machines() == 0)
+            return 0;
+
+        size_t longest{};
+        size_t total{};
+        for (size_t i{}; i < matrix.tasks(); ++i)
+        {
+            auto fastest = matrix(i, 0);
+            for (size_t j{1}; j < matrix.machines(); ++j)
+                fastest = std::min(fastest, matrix(i, j));
+
+            longest = std::max(longest, fastest);
+            total += fastest;
+        }
+
+        // Round the even spread up, since makespans are whole numbers.
+        return std::max(longest, (total + matrix.machines() - 1) / matrix.machines());
     }
 }
 
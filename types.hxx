@@ -25,6 +25,13 @@
 #include <iosfwd>
 #include <random>
 
+#ifdef CS340_CHUNKED_SCHEDULE
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#endif
+
 //------------------------------------------------------------------------------
 
 namespace cs340 
@@ -38,14 +45,27 @@ namespace cs340
   // A schedule is a vector of length T, where T is the number of
   // tasks to assign. Each element t[k] is a value in the range [0,
   // M), where M is the number of that we can assign tasks to.
+  //
+  // When built with CS340_CHUNKED_SCHEDULE defined, the vector is split
+  // into fixed-size chunks that are shared between copies of a schedule
+  // and only copied when one of the copies changes them. Crossover then
+  // shares the chunks it takes over whole, and mutation copies only the
+  // chunk it touches. Each chunk also caches how much time its tasks add
+  // to each machine, so rescoring only has to look at changed chunks.
+  // This is meant for task counts in the millions, where copying whole
+  // schedules dominates the run time and the memory use.
   struct schedule 
   {
     schedule() = default;
 
+#ifdef CS340_CHUNKED_SCHEDULE
+    explicit schedule(std::size_t sz);
+#else
     explicit schedule(std::size_t sz)
       : data_(sz)
     { 
     }
+#endif
 
     schedule(schedule const&) = default;
     schedule(schedule&&) = default;
@@ -55,6 +75,29 @@ namespace cs340
 
     ~schedule() = default;
 
+#ifdef CS340_CHUNKED_SCHEDULE
+    // Number of tasks in a chunk. A power of two, so that finding a
+    // task's chunk is a shift and a mask.
+    static constexpr std::size_t chunk_size = 4096;
+
+    auto task_assignment(size_t i) const 
+    { 
+      return chunks_[i / chunk_size]->genes[i % chunk_size]; 
+    }
+
+    void set_task_assignment(size_t i, size_t m)
+    { 
+      auto& c = writable_chunk(i / chunk_size);
+      c.genes[i % chunk_size] = m; 
+      c.has_loads = false;
+      has_cache_ = false; 
+    }
+
+    auto tasks() const 
+    { 
+      return tasks_; 
+    }
+#else
     auto task_assignment(size_t i) const 
     { 
       return data_[i]; 
@@ -70,6 +113,15 @@ namespace cs340
     { 
       return data_.size(); 
     }
+#endif
+
+    // Copy the task assignments [first, last) from another schedule of
+    // the same length, e.g., during crossover.
+    void assign_range(schedule const&, std::size_t first, std::size_t last);
+
+    // Copy count task assignments, starting with task first, to out.
+    void copy_task_assignments(std::size_t first, std::size_t count,
+      std::size_t* out) const;
 
     // Scoring a chromosome involves computig the "makespan" of the
     // schedule. We use the times stored in the matrix to compute
@@ -80,10 +132,57 @@ namespace cs340
     // complete all tasks, from start to finish.
     double score(runtime_matrix const&) const;
 
+    // The makespan itself. It is cached along with the score.
+    std::size_t makespan(runtime_matrix const&) const;
+
+    // Fill in the cache with a makespan that was computed elsewhere,
+    // e.g., by score_batch().
+    void cache_makespan(std::size_t) const;
+
   private:
+#ifdef CS340_CHUNKED_SCHEDULE
+    // A chunk is only ever changed in place while a single schedule
+    // owns it, but the cached loads of a shared chunk may be computed
+    // by any of the threads that hold it, hence the lock.
+    //
+    // Schedules on different threads may share chunks, e.g., after a
+    // warm-start pool is dealt out to the islands. A schedule that finds
+    // itself the only owner must therefore see everything the previous
+    // owners did to the chunk before it changes it; see writable_chunk().
+    struct chunk
+    {
+      explicit chunk(std::vector<std::size_t> g)
+        : genes(std::move(g))
+      {
+      }
+
+      std::vector<std::size_t> genes;
+      mutable std::atomic<bool> has_loads{false};
+      mutable std::mutex loads_mutex;
+      mutable std::vector<std::size_t> loads;
+    };
+
+    // Make sure chunk k is not shared before changing it. use_count()
+    // is only a relaxed load, so the fence is what orders the other
+    // owners' last reads of the chunk (which happen before they release
+    // it) before the writes made here.
+    chunk& writable_chunk(std::size_t k)
+    {
+      if (chunks_[k].use_count() != 1)
+        chunks_[k] = std::make_shared<chunk>(chunks_[k]->genes);
+      else
+        std::atomic_thread_fence(std::memory_order_acquire);
+      return *chunks_[k];
+    }
+
+    std::vector<std::shared_ptr<chunk>> chunks_;
+    std::size_t tasks_ = 0;
+#else
     std::vector<std::size_t> data_;
+#endif
     mutable bool has_cache_ = false;
     mutable double cached_score_;
+    mutable std::size_t cached_makespan_;
   };
 
   // So that we can output solutions.
@@ -143,6 +242,13 @@ namespace cs340
   // Parameters are (i, j), max-time, and a random_generator.
   runtime_matrix create_random_matrix(std::size_t, std::size_t, std::size_t,
     random_generator&);
+
+  // A lower bound on the makespan of any schedule for the matrix. Every
+  // task takes at least its fastest time, so the makespan is at least
+  // the largest of those, and at least their sum spread evenly over all
+  // of the machines. Computing it costs about as much as scoring one
+  // schedule.
+  std::size_t makespan_lower_bound(runtime_matrix const&);
 }
 
 //------------------------------------------------------------------------------